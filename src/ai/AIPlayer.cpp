@@ -1,6 +1,5 @@
 #include "AIPlayer.h"
 #include <QFuture>
-#include <QtConcurrent>
 
 AIPlayer::AIPlayer(ChessBoard::PieceType pieceType, int difficulty, QObject *parent)
     : Player(pieceType, parent)
@@ -25,10 +24,12 @@ void AIPlayer::requestMove(const ChessBoard* board)
     
     m_thinking = true;
     
-    // 在独立线程中计算最佳移动
-    QFuture<QPoint> future = QtConcurrent::run([this, board]() {
-        return calculateMove(board);
-    });
+    // 交给AI调度器在工作线程中计算最佳移动
+    QFuture<QPoint> future = AIScheduler::instance()->submit(
+        AIScheduler::Interactive, searchDepth(), -1,
+        [this, board](const AIScheduler::SearchContext& context) {
+            return calculateMove(board, context);
+        });
     
     m_watcher->setFuture(future);
 }
@@ -36,7 +37,9 @@ void AIPlayer::requestMove(const ChessBoard* board)
 void AIPlayer::cancelMove()
 {
     if (m_thinking && m_watcher->isRunning()) {
+        // 搜索会在下一个检查点看到停止标志，这里的等待很短
         m_watcher->cancel();
+        AIScheduler::instance()->cancel(m_watcher->future());
         m_watcher->waitForFinished();
         m_thinking = false;
         emit moveCancelled();
@@ -4,6 +4,7 @@
 #include <QThread>
 #include <QFutureWatcher>
 #include "core/Player.h"
+#include "AIScheduler.h"
 
 // AI玩家基类
 class AIPlayer : public Player
@@ -23,7 +24,10 @@ public:
     void setDifficulty(int difficulty) { m_difficulty = difficulty; }
 
 protected:
-    virtual QPoint calculateMove(const ChessBoard* board) = 0;
+    // 期望的搜索深度，调度器在高负载时可能降低
+    virtual int searchDepth() const = 0;
+    // 在工作线程中执行，应定期检查context.stop以便及时响应取消
+    virtual QPoint calculateMove(const ChessBoard* board, const AIScheduler::SearchContext& context) = 0;
 
 private slots:
     void onCalculationFinished();
@@ -0,0 +1,219 @@
+#include "AIScheduler.h"
+#include <QThread>
+#include <QMutexLocker>
+
+AIScheduler* AIScheduler::s_instance = nullptr;
+
+AIScheduler* AIScheduler::instance()
+{
+    if (!s_instance) {
+        s_instance = new AIScheduler(QThread::idealThreadCount());
+    }
+    return s_instance;
+}
+
+AIScheduler::AIScheduler(int workerCount, QObject *parent)
+    : QObject(parent)
+    , m_workerCount(qMax(1, workerCount))
+    , m_activeWorkers(0)
+{
+    m_pool.setMaxThreadCount(m_workerCount);
+}
+
+AIScheduler::~AIScheduler()
+{
+    // 丢弃尚未开始的请求，通知正在执行的搜索停止并等待其结束
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto& queue : m_queues) {
+            for (Request& request : queue) {
+                finishCanceled(request.result);
+            }
+            queue.clear();
+        }
+        for (RunningRequest& running : m_running) {
+            running.stop->store(true, std::memory_order_relaxed);
+        }
+    }
+    m_pool.waitForDone();
+
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+}
+
+QFuture<QPoint> AIScheduler::submit(Priority priority, int depth, qint64 deadlineMs, SearchFunction search)
+{
+    Request request;
+    request.result.reportStarted();
+    request.search = std::move(search);
+    request.deadline = deadlineMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever)
+                                      : QDeadlineTimer(deadlineMs);
+    request.stop = std::make_shared<std::atomic_bool>(false);
+    request.depth = qMax(MIN_DEPTH, depth);
+    request.priority = priority;
+
+    QFuture<QPoint> future = request.result.future();
+
+    QMutexLocker locker(&m_mutex);
+    int queued = static_cast<int>(m_queues[Interactive].size() + m_queues[Analysis].size());
+    if (queued >= queueLimit(priority)) {
+        finishCanceled(request.result);
+        return future;
+    }
+
+    m_queues[priority].push_back(std::move(request));
+
+    // 每个工作线程持续取任务直到队列为空，避免每个请求单独派发
+    if (m_activeWorkers < m_workerCount) {
+        m_activeWorkers++;
+        m_pool.start([this]() { drainQueue(); });
+    }
+
+    return future;
+}
+
+bool AIScheduler::cancel(const QFuture<QPoint>& future)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto& queue : m_queues) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->result.future() == future) {
+                finishCanceled(it->result);
+                queue.erase(it);
+                return true;
+            }
+        }
+    }
+    
+    for (RunningRequest& running : m_running) {
+        if (running.future == future) {
+            running.stop->store(true, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AIScheduler::canAdmit(Priority priority) const
+{
+    QMutexLocker locker(&m_mutex);
+    int queued = static_cast<int>(m_queues[Interactive].size() + m_queues[Analysis].size());
+    return queued < queueLimit(priority);
+}
+
+int AIScheduler::queuedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_queues[Interactive].size() + m_queues[Analysis].size());
+}
+
+int AIScheduler::runningCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_running.size());
+}
+
+void AIScheduler::drainQueue()
+{
+    Request request;
+    while (takeNext(&request)) {
+        // 分析任务以较低的线程优先级运行，避免与交互对局争抢CPU
+        QThread* thread = QThread::currentThread();
+        QThread::Priority oldPriority = thread->priority();
+        if (request.priority == Analysis) {
+            thread->setPriority(QThread::LowPriority);
+        }
+
+        SearchContext context;
+        context.depth = request.depth;
+        context.stop = request.stop.get();
+        context.deadline = request.deadline;
+        QPoint move = request.search(context);
+
+        if (request.priority == Analysis) {
+            thread->setPriority(oldPriority);
+        }
+
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_running.begin(); it != m_running.end(); ++it) {
+            if (it->stop == request.stop) {
+                m_running.erase(it);
+                break;
+            }
+        }
+        locker.unlock();
+
+        request.result.reportResult(move);
+        request.result.reportFinished();
+    }
+}
+
+bool AIScheduler::takeNext(Request* request)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (;;) {
+        std::deque<Request>* queue = nullptr;
+        if (!m_queues[Interactive].empty()) {
+            queue = &m_queues[Interactive];
+        } else if (!m_queues[Analysis].empty()) {
+            queue = &m_queues[Analysis];
+        }
+
+        if (!queue) {
+            m_activeWorkers--;
+            return false;
+        }
+
+        *request = std::move(queue->front());
+        queue->pop_front();
+
+        if (request->result.isCanceled()) {
+            request->result.reportFinished();
+            continue;
+        }
+
+        int queued = static_cast<int>(m_queues[Interactive].size() + m_queues[Analysis].size());
+        if (request->deadline.hasExpired()) {
+            // 过期的分析任务直接丢弃，交互对局必须给出落子，只降到最低深度
+            if (request->priority == Analysis) {
+                finishCanceled(request->result);
+                continue;
+            }
+            request->depth = MIN_DEPTH;
+            request->deadline = QDeadlineTimer(QDeadlineTimer::Forever);
+        } else {
+            request->depth = depthUnderLoad(request->depth, queued);
+        }
+
+        m_running.push_back({ request->result.future(), request->stop });
+        return true;
+    }
+}
+
+int AIScheduler::depthUnderLoad(int requested, int queued) const
+{
+    // 负载 = 每个工作线程平均排队的请求数
+    int load = queued / m_workerCount;
+    if (load < 1) {
+        return requested;
+    }
+    if (load < 4) {
+        return qMax(MIN_DEPTH, requested - 2);
+    }
+    return MIN_DEPTH;
+}
+
+int AIScheduler::queueLimit(Priority priority) const
+{
+    // 分析任务只能占用一半队列，为交互对局保留余量
+    int limit = m_workerCount * MAX_QUEUED_PER_WORKER;
+    return priority == Interactive ? limit : limit / 2;
+}
+
+void AIScheduler::finishCanceled(QFutureInterface<QPoint>& result)
+{
+    result.reportCanceled();
+    result.reportFinished();
+}
@@ -0,0 +1,91 @@
+#ifndef AISCHEDULER_H
+#define AISCHEDULER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMutex>
+#include <QDeadlineTimer>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QPoint>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <functional>
+
+// AI搜索调度器
+// 固定大小的工作线程池 + 按优先级排队：交互对局优先于分析任务。
+// 负载升高时降低搜索深度而不是无限排队，队列满时直接拒绝新请求。
+class AIScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority { Interactive = 0, Analysis = 1 };
+
+    // 传给搜索函数的执行参数
+    struct SearchContext {
+        int depth;                    // 调度器最终批准的搜索深度
+        const std::atomic_bool* stop; // 被取消时置位，搜索应尽快返回
+        QDeadlineTimer deadline;
+    };
+
+    // 在工作线程中执行的搜索函数
+    using SearchFunction = std::function<QPoint(const SearchContext& context)>;
+
+    static AIScheduler* instance();
+
+    explicit AIScheduler(int workerCount, QObject *parent = nullptr);
+    ~AIScheduler();
+
+    // 提交搜索请求；deadlineMs < 0 表示不限时。
+    // 被拒绝或被丢弃的请求返回已取消的QFuture。
+    QFuture<QPoint> submit(Priority priority, int depth, qint64 deadlineMs, SearchFunction search);
+
+    // 撤销排队中的请求；已开始执行的请求通过停止标志通知搜索尽快返回
+    bool cancel(const QFuture<QPoint>& future);
+
+    // 准入检查：队列已满时返回false
+    bool canAdmit(Priority priority) const;
+
+    int workerCount() const { return m_workerCount; }
+    int queuedCount() const;
+    int runningCount() const;
+
+    static const int MIN_DEPTH = 1;
+
+private:
+    struct Request {
+        QFutureInterface<QPoint> result;
+        SearchFunction search;
+        QDeadlineTimer deadline;
+        std::shared_ptr<std::atomic_bool> stop;
+        int depth;
+        Priority priority;
+    };
+
+    struct RunningRequest {
+        QFuture<QPoint> future;
+        std::shared_ptr<std::atomic_bool> stop;
+    };
+
+    void drainQueue();
+    bool takeNext(Request* request);
+    int depthUnderLoad(int requested, int queued) const;
+    int queueLimit(Priority priority) const;
+    static void finishCanceled(QFutureInterface<QPoint>& result);
+
+    int m_workerCount;
+    QThreadPool m_pool;
+
+    mutable QMutex m_mutex;
+    std::deque<Request> m_queues[2];
+    std::vector<RunningRequest> m_running;
+    int m_activeWorkers;
+
+    static const int MAX_QUEUED_PER_WORKER = 32;
+    static AIScheduler* s_instance;
+};
+
+#endif // AISCHEDULER_H
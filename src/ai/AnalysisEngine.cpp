@@ -0,0 +1,231 @@
+#include "AnalysisEngine.h"
+#include <QThread>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+AnalysisEngine::AnalysisEngine(QObject *parent)
+    : QObject(parent)
+    , m_gameEngine(nullptr)
+    , m_enabled(false)
+    , m_restartPending(false)
+    , m_active(false)
+    , m_lineCount(3)
+    , m_maxDepth(DEFAULT_MAX_DEPTH)
+    , m_lastBestMove(-1, -1)
+    , m_hasJob(false)
+    , m_quit(false)
+    , m_abort(false)
+    , m_generation(0)
+{
+}
+
+AnalysisEngine::~AnalysisEngine()
+{
+    if (m_thread) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_quit = true;
+            m_abort.store(true, std::memory_order_relaxed);
+            m_wake.wakeAll();
+        }
+        m_thread->wait();
+    }
+}
+
+void AnalysisEngine::setGameEngine(GameEngine* engine)
+{
+    if (m_gameEngine) {
+        disconnect(m_gameEngine, nullptr, this, nullptr);
+    }
+
+    m_gameEngine = engine;
+
+    if (m_gameEngine) {
+        connect(m_gameEngine, &GameEngine::moveMade,
+                this, &AnalysisEngine::onMoveMade);
+        connect(m_gameEngine, &GameEngine::moveUndone,
+                this, &AnalysisEngine::onMoveUndone);
+        connect(m_gameEngine, &GameEngine::gameStateChanged,
+                this, &AnalysisEngine::onGameStateChanged);
+    }
+
+    scheduleRestart();
+}
+
+void AnalysisEngine::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+
+    m_enabled = enabled;
+    if (m_enabled) {
+        scheduleRestart();
+    } else {
+        stop();
+    }
+}
+
+void AnalysisEngine::onMoveMade(const QPoint& position, ChessBoard::PieceType piece)
+{
+    Q_UNUSED(position)
+    Q_UNUSED(piece)
+    scheduleRestart();
+}
+
+void AnalysisEngine::onMoveUndone(const QPoint& position)
+{
+    Q_UNUSED(position)
+    scheduleRestart();
+}
+
+void AnalysisEngine::onGameStateChanged(GameEngine::GameState state)
+{
+    Q_UNUSED(state)
+    scheduleRestart();
+}
+
+void AnalysisEngine::scheduleRestart()
+{
+    // 人机悔棋等操作会连续发出多个信号，合并到事件循环的下一轮只重启一次；
+    // 旧搜索现在就停下，不再为过期的局面消耗CPU
+    m_abort.store(true, std::memory_order_relaxed);
+    if (m_restartPending) {
+        return;
+    }
+    m_restartPending = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_restartPending = false;
+        restart();
+    }, Qt::QueuedConnection);
+}
+
+bool AnalysisEngine::shouldAnalyze() const
+{
+    return m_enabled && m_gameEngine && m_gameEngine->chessBoard() &&
+           m_gameEngine->gameState() == GameEngine::Playing;
+}
+
+void AnalysisEngine::restart()
+{
+    if (!shouldAnalyze()) {
+        stop();
+        return;
+    }
+
+    const ChessBoard* board = m_gameEngine->chessBoard();
+
+    Job job;
+    job.snapshot = board->serialize();
+    job.side = (board->moveCount() % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+    job.maxDepth = m_maxDepth;
+    job.lineCount = m_lineCount;
+    job.generation = m_generation.fetch_add(1) + 1;
+
+    if (!m_thread) {
+        m_thread.reset(QThread::create([this]() { run(); }));
+        m_thread->start(QThread::LowestPriority);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_job = job;
+        m_hasJob = true;
+        m_abort.store(true, std::memory_order_relaxed);
+        m_wake.wakeOne();
+    }
+
+    m_lastBestMove = QPoint(-1, -1);
+    m_active = true;
+    emit analysisStarted();
+}
+
+void AnalysisEngine::stop()
+{
+    // 递增代数使已在排队中的结果作废
+    m_generation.fetch_add(1);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_hasJob = false;
+        m_abort.store(true, std::memory_order_relaxed);
+    }
+
+    m_lastBestMove = QPoint(-1, -1);
+    if (m_active) {
+        m_active = false;
+        emit analysisStopped();
+    }
+}
+
+void AnalysisEngine::run()
+{
+    for (;;) {
+        Job job;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_hasJob && !m_quit) {
+                m_wake.wait(&m_mutex);
+            }
+            if (m_quit) {
+                return;
+            }
+            job = m_job;
+            m_hasJob = false;
+            m_abort.store(false, std::memory_order_relaxed);
+        }
+
+        analyze(job);
+    }
+}
+
+void AnalysisEngine::analyze(const Job& job)
+{
+    ChessBoard position;
+    if (!position.deserialize(job.snapshot)) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    quint64 nodes = 0;
+    m_heatmap.reset();
+
+    // 逐层加深，每层结束时送出一次完整结果；被打断的那一层不完整，直接丢弃
+    for (int depth = 1; depth <= job.maxDepth; ++depth) {
+        MinimaxSearch search(job.side, depth);
+        search.setStopFlag(&m_abort);
+        search.setHeatmap(&m_heatmap);
+        QVector<MinimaxSearch::RootMove> lines = search.findTopMoves(&position, job.lineCount);
+        nodes += search.nodeCount();
+
+        if (search.wasStopped() || m_abort.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Info info;
+        info.depth = depth;
+        info.side = job.side;
+        info.lines = lines;
+        info.nodes = nodes;
+        info.elapsedMs = timer.elapsed();
+        publish(job.generation, info);
+    }
+}
+
+void AnalysisEngine::publish(quint64 generation, const Info& info)
+{
+    // 在分析线程调用，结果排队送到界面线程；到达时局面可能已经变化，按代数过滤
+    QMetaObject::invokeMethod(this, [this, generation, info]() {
+        if (generation != m_generation.load()) {
+            return;
+        }
+
+        emit infoUpdated(info);
+
+        const QPoint best = info.bestMove();
+        if (best != m_lastBestMove) {
+            m_lastBestMove = best;
+            emit bestMoveChanged(best, info.score());
+        }
+    }, Qt::QueuedConnection);
+}
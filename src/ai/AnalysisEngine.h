@@ -0,0 +1,108 @@
+#ifndef ANALYSISENGINE_H
+#define ANALYSISENGINE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QVector>
+#include <QPoint>
+#include <atomic>
+#include <memory>
+#include "core/GameEngine.h"
+#include "MinimaxSearch.h"
+#include "SearchHeatmap.h"
+
+class QThread;
+
+// 后台局面分析
+// 专用的低优先级线程对当前局面做逐层加深的多主变搜索，每完成一层就把评估结果
+// 通过排队信号送回界面线程。局面变化时只置位停止标志并交给线程一份新快照，
+// 线程本身常驻，不会为每步棋重新创建。
+// 不占用AIScheduler的工作线程，AI对手的计算不会因为分析而排队。
+class AnalysisEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 一层搜索完成后的分析结果，站在side一方
+    struct Info {
+        int depth;
+        ChessBoard::PieceType side;
+        QVector<MinimaxSearch::RootMove> lines;  // 按分数从高到低
+        quint64 nodes;
+        qint64 elapsedMs;
+
+        QPoint bestMove() const { return lines.isEmpty() ? QPoint(-1, -1) : lines.first().move; }
+        int score() const { return lines.isEmpty() ? 0 : lines.first().score; }
+    };
+
+    explicit AnalysisEngine(QObject *parent = nullptr);
+    ~AnalysisEngine();
+
+    // 跟随引擎的落子、悔棋和状态变化自动重新开始分析
+    void setGameEngine(GameEngine* engine);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+    bool isActive() const { return m_active; }
+
+    void setLineCount(int count) { m_lineCount = qBound(1, count, MAX_LINES); }
+    void setMaxDepth(int depth) { m_maxDepth = qBound(1, depth, MinimaxSearch::MAX_PLY - 1); }
+    
+    // 分析线程写入、界面按帧率读取的根节点热力图
+    const SearchHeatmap* heatmap() const { return &m_heatmap; }
+
+    static const int DEFAULT_MAX_DEPTH = 8;
+    static const int MAX_LINES = 5;
+
+signals:
+    void analysisStarted();
+    void infoUpdated(const AnalysisEngine::Info& info);
+    void bestMoveChanged(const QPoint& move, int score);
+    void analysisStopped();
+
+private slots:
+    void onMoveMade(const QPoint& position, ChessBoard::PieceType piece);
+    void onMoveUndone(const QPoint& position);
+    void onGameStateChanged(GameEngine::GameState state);
+
+private:
+    struct Job {
+        QByteArray snapshot;
+        ChessBoard::PieceType side;
+        int maxDepth;
+        int lineCount;
+        quint64 generation;
+    };
+
+    void scheduleRestart();
+    void restart();
+    void stop();
+    bool shouldAnalyze() const;
+
+    // 分析线程
+    void run();
+    void analyze(const Job& job);
+    void publish(quint64 generation, const Info& info);
+
+    GameEngine* m_gameEngine;
+    bool m_enabled;
+    bool m_restartPending;
+    bool m_active;
+    int m_lineCount;
+    int m_maxDepth;
+    QPoint m_lastBestMove;
+
+    std::unique_ptr<QThread> m_thread;
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    Job m_job;
+    bool m_hasJob;
+    bool m_quit;
+    std::atomic_bool m_abort;               // 当前搜索应尽快返回
+    std::atomic<quint64> m_generation;      // 每次重新开始加一，用于丢弃过期结果
+    SearchHeatmap m_heatmap;                // 只由分析线程写入
+};
+
+#endif // ANALYSISENGINE_H
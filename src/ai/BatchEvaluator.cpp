@@ -0,0 +1,89 @@
+#include "BatchEvaluator.h"
+#include "MinimaxSearch.h"
+#include <QThreadPool>
+#include <QSemaphore>
+#include <atomic>
+
+BatchEvaluator::BatchEvaluator(QThreadPool* pool)
+    : m_pool(pool ? pool : QThreadPool::globalInstance())
+{
+}
+
+void BatchEvaluator::evaluate(const CompactPosition* positions, int count, qint32* scores) const
+{
+    if (!positions || !scores || count <= 0) {
+        return;
+    }
+
+    const int chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::atomic_int nextChunk(0);
+
+    // 各线程按块动态领取，块之间互不重叠，结果直接写入scores对应位置
+    auto work = [&]() {
+        for (int chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+            const int begin = chunk * CHUNK_SIZE;
+            const int end = qMin(count, begin + CHUNK_SIZE);
+            for (int i = begin; i < end; ++i) {
+                scores[i] = evaluateOne(positions[i]);
+            }
+        }
+    };
+
+    // 只借用线程池中当前空闲的线程；线程池忙（包括在池内线程中调用）时由调用线程独自完成，
+    // 不会因为等待排队中的任务而互相阻塞
+    QSemaphore finished;
+    int helpers = 0;
+    const int wanted = qMin(chunkCount - 1, m_pool->maxThreadCount());
+    for (int i = 0; i < wanted; ++i) {
+        if (!m_pool->tryStart([&]() { work(); finished.release(); })) {
+            break;
+        }
+        helpers++;
+    }
+
+    work();
+    finished.acquire(helpers);
+}
+
+QVector<qint32> BatchEvaluator::evaluate(const QVector<CompactPosition>& positions) const
+{
+    QVector<qint32> scores(positions.size());
+    evaluate(positions.constData(), positions.size(), scores.data());
+    return scores;
+}
+
+qint32 BatchEvaluator::evaluateOne(const CompactPosition& position)
+{
+    LineBoard lines;
+    MoveIndex stones[MoveIndex::CELL_COUNT];
+    int stoneCount = 0;
+    int blackCount = 0;
+
+    // 逐字节解码，整字节为空时直接跳过
+    for (int byte = 0; byte < CompactPosition::PACKED_BYTES; ++byte) {
+        const quint8 packed = position.cells[byte];
+        if (packed == 0) {
+            continue;
+        }
+        for (int slot = 0; slot < 4; ++slot) {
+            const int piece = (packed >> (slot * 2)) & 0x3;
+            const int index = byte * 4 + slot;
+            if (piece == ChessBoard::Empty || piece > ChessBoard::White || index >= MoveIndex::CELL_COUNT) {
+                continue;
+            }
+            const MoveIndex move(static_cast<quint8>(index));
+            lines.place(move, piece);
+            stones[stoneCount++] = move;
+            if (piece == ChessBoard::Black) {
+                blackCount++;
+            }
+        }
+    }
+
+    ChessBoard::PieceType perspective = static_cast<ChessBoard::PieceType>(position.sideToMove);
+    if (perspective != ChessBoard::Black && perspective != ChessBoard::White) {
+        perspective = (blackCount * 2 == stoneCount) ? ChessBoard::Black : ChessBoard::White;
+    }
+
+    return MinimaxSearch::evaluate(lines, stones, stoneCount, perspective);
+}
@@ -0,0 +1,32 @@
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include <QVector>
+#include "core/CompactPosition.h"
+
+class QThreadPool;
+
+// 批量局面评估
+// 对连续存放的CompactPosition数组逐个做静态评估（与Minimax叶节点相同的评分），
+// 数组按块切分后由线程池中的多个线程动态领取，调用线程也参与计算。
+// 每个局面只在栈上解码成位棋盘，不构造任何QObject。
+class BatchEvaluator
+{
+public:
+    // pool为空时使用QThreadPool::globalInstance()
+    explicit BatchEvaluator(QThreadPool* pool = nullptr);
+
+    // 分数站在每个局面的行棋方一边；sideToMove为0时按双方子数推断（子数相等时黑方行棋）
+    void evaluate(const CompactPosition* positions, int count, qint32* scores) const;
+    QVector<qint32> evaluate(const QVector<CompactPosition>& positions) const;
+
+    static qint32 evaluateOne(const CompactPosition& position);
+
+    // 每个工作块包含的局面数
+    static const int CHUNK_SIZE = 512;
+
+private:
+    QThreadPool* m_pool;
+};
+
+#endif // BATCHEVALUATOR_H
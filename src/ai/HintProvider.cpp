@@ -0,0 +1,74 @@
+#include "HintProvider.h"
+
+HintProvider::HintProvider(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFutureWatcher<QPoint>(this))
+    , m_busy(false)
+{
+    connect(m_watcher, &QFutureWatcher<QPoint>::finished,
+            this, &HintProvider::onSearchFinished);
+}
+
+HintProvider::~HintProvider()
+{
+    cancel();
+}
+
+void HintProvider::requestHints(const ChessBoard* board, ChessBoard::PieceType side, int count, int depth)
+{
+    cancel();
+
+    if (!board || !AIScheduler::instance()->canAdmit(AIScheduler::Analysis)) {
+        emit hintsUnavailable();
+        return;
+    }
+
+    // 工作线程使用局面快照，界面线程上的棋盘在搜索期间可以继续变化
+    const QByteArray snapshot = board->serialize();
+    auto result = std::make_shared<QVector<MinimaxSearch::RootMove>>();
+    m_result = result;
+    m_busy = true;
+
+    QFuture<QPoint> future = AIScheduler::instance()->submit(
+        AIScheduler::Analysis, depth, DEADLINE_MS,
+        [snapshot, side, count, result](const AIScheduler::SearchContext& context) {
+            ChessBoard position;
+            position.deserialize(snapshot);
+
+            MinimaxSearch search(side, context.depth);
+            search.setStopFlag(context.stop);
+            search.setDeadline(context.deadline);
+            *result = search.findTopMoves(&position, count);
+            return result->isEmpty() ? QPoint(-1, -1) : result->first().move;
+        });
+
+    m_watcher->setFuture(future);
+}
+
+void HintProvider::cancel()
+{
+    if (!m_busy) {
+        return;
+    }
+
+    // 结果对象由工作线程持有一份引用，这里不必等待搜索真正结束；
+    // 之后的setFuture会断开旧的future，迟到的完成通知由m_busy过滤
+    AIScheduler::instance()->cancel(m_watcher->future());
+    m_result.reset();
+    m_busy = false;
+}
+
+void HintProvider::onSearchFinished()
+{
+    if (!m_busy) {
+        return;
+    }
+    m_busy = false;
+    std::shared_ptr<QVector<MinimaxSearch::RootMove>> result = std::move(m_result);
+
+    if (m_watcher->isCanceled() || !result || result->isEmpty()) {
+        emit hintsUnavailable();
+        return;
+    }
+    emit hintsReady(*result);
+}
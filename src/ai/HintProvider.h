@@ -0,0 +1,46 @@
+#ifndef HINTPROVIDER_H
+#define HINTPROVIDER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QVector>
+#include <memory>
+#include "core/ChessBoard.h"
+#include "AIScheduler.h"
+#include "MinimaxSearch.h"
+
+// 落子提示
+// 对当前局面做一次多主变搜索，给出前几名候选着法及其分数和预期变化。
+// 搜索以分析优先级交给AI调度器，不阻塞界面，也不会挤占AI对手的计算。
+class HintProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HintProvider(QObject *parent = nullptr);
+    ~HintProvider();
+
+    // 为side一方请求count个候选着法；已有请求在进行时先撤销旧请求
+    void requestHints(const ChessBoard* board, ChessBoard::PieceType side,
+                      int count = DEFAULT_COUNT, int depth = DEFAULT_DEPTH);
+    void cancel();
+    bool isBusy() const { return m_busy; }
+
+    static const int DEFAULT_COUNT = 3;
+    static const int DEFAULT_DEPTH = 4;
+    static const int DEADLINE_MS = 3000;
+
+signals:
+    void hintsReady(const QVector<MinimaxSearch::RootMove>& hints);
+    void hintsUnavailable();
+
+private slots:
+    void onSearchFinished();
+
+private:
+    QFutureWatcher<QPoint>* m_watcher;
+    std::shared_ptr<QVector<MinimaxSearch::RootMove>> m_result;
+    bool m_busy;
+};
+
+#endif // HINTPROVIDER_H
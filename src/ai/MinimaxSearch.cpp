@@ -0,0 +1,443 @@
+#include "MinimaxSearch.h"
+#include "SearchHeatmap.h"
+#include <QRandomGenerator>
+#include <algorithm>
+#include <memory>
+
+MinimaxSearch::MinimaxSearch(ChessBoard::PieceType pieceType, int maxDepth)
+    : m_pieceType(pieceType)
+    , m_maxDepth(qBound(1, maxDepth, MAX_PLY - 1))
+    , m_arena(nullptr)
+    , m_stopFlag(nullptr)
+    , m_deadline(QDeadlineTimer::Forever)
+    , m_nodeCount(0)
+    , m_stopped(false)
+    , m_lastScore(0)
+    , m_heatmap(nullptr)
+{
+}
+
+MinimaxSearch::SearchArena& MinimaxSearch::SearchArena::local()
+{
+    // 每个线程只在第一次搜索时分配一次
+    static thread_local std::unique_ptr<SearchArena> arena;
+    if (!arena) {
+        arena.reset(new SearchArena());
+    }
+    return *arena;
+}
+
+QPoint MinimaxSearch::findBestMove(const ChessBoard* board)
+{
+    m_lastScore = 0;
+    if (!board || !board->hasHistory()) {
+        // 如果是第一步，下在中心位置
+        return QPoint(7, 7);
+    }
+
+    m_arena = &SearchArena::local();
+    m_arena->board.load(board);
+
+    m_nodeCount = 0;
+    m_stopped = false;
+    MoveScore bestMove = minimax(0, m_maxDepth, true);
+    m_lastScore = bestMove.score;
+
+    // 如果没有找到好的移动，随机选择一个
+    if (!bestMove.move.isValid()) {
+        MoveList& candidates = m_arena->lists[0];
+        generateCandidateMoves(candidates);
+        if (candidates.count > 0) {
+            int randomIndex = QRandomGenerator::global()->bounded(candidates.count);
+            bestMove.move = candidates.moves[randomIndex];
+        }
+    }
+
+    m_arena = nullptr;
+    return bestMove.move.toPoint();
+}
+
+QVector<MinimaxSearch::RootMove> MinimaxSearch::findTopMoves(const ChessBoard* board, int count)
+{
+    QVector<RootMove> result;
+    count = qBound(1, count, static_cast<int>(MAX_CANDIDATES));
+    m_lastScore = 0;
+
+    if (!board || !board->hasHistory()) {
+        RootMove center;
+        center.move = QPoint(7, 7);
+        center.score = 0;
+        center.variation.append(center.move);
+        result.append(center);
+        return result;
+    }
+
+    m_arena = &SearchArena::local();
+    m_arena->board.load(board);
+    m_nodeCount = 0;
+    m_stopped = false;
+
+    // 根节点单独展开：alpha取当前第K名的分数，只有可能进入前K名的着法才会被精确求值，
+    // 其余着法很快被剪掉。各候选的子树只搜索一次，而不是跑K遍完整搜索。
+    struct TopEntry {
+        int score;
+        int length;
+        MoveIndex line[MAX_PLY];
+    };
+    TopEntry top[MAX_CANDIDATES];
+    int found = 0;
+
+    SearchBoard& searchBoard = m_arena->board;
+    MoveList& candidates = m_arena->lists[0];
+    generateCandidateMoves(candidates);
+
+    for (int i = 0; i < candidates.count; ++i) {
+        const MoveIndex move = candidates.moves[i];
+        searchBoard.place(move, m_pieceType);
+
+        int score = WIN_SCORE;
+        const quint64 nodesBefore = m_nodeCount;
+        m_arena->pvLength[1] = 0;
+        if (!isWinningMove(move, m_pieceType)) {
+            const int alpha = (found < count) ? INT_MIN : top[count - 1].score;
+            score = minimax(1, m_maxDepth - 1, false, alpha, INT_MAX).score;
+        }
+        searchBoard.undo();
+
+        if (m_stopped) {
+            break;
+        }
+        if (m_heatmap) {
+            m_heatmap->record(move, score, m_nodeCount - nodesBefore + 1);
+        }
+        if (found == count && score <= top[count - 1].score) {
+            continue;
+        }
+
+        // 按分数从高到低插入
+        int position = qMin(found, count - 1);
+        while (position > 0 && top[position - 1].score < score) {
+            top[position] = top[position - 1];
+            position--;
+        }
+        TopEntry& entry = top[position];
+        entry.score = score;
+        entry.line[0] = move;
+        entry.length = qMin(m_arena->pvLength[1] + 1, static_cast<int>(MAX_PLY));
+        for (int ply = 1; ply < entry.length; ++ply) {
+            entry.line[ply] = m_arena->pv[1][ply - 1];
+        }
+        found = qMin(found + 1, count);
+    }
+
+    m_arena = nullptr;
+
+    result.reserve(found);
+    for (int i = 0; i < found; ++i) {
+        RootMove rootMove;
+        rootMove.move = top[i].line[0].toPoint();
+        rootMove.score = top[i].score;
+        for (int ply = 0; ply < top[i].length; ++ply) {
+            rootMove.variation.append(top[i].line[ply].toPoint());
+        }
+        result.append(rootMove);
+    }
+    if (!result.isEmpty()) {
+        m_lastScore = result.first().score;
+    }
+    return result;
+}
+
+int MinimaxSearch::scoreMove(const ChessBoard* board, const QPoint& position)
+{
+    const MoveIndex move = MoveIndex::fromPoint(position);
+    if (!board || !move.isValid() || !board->isEmpty(position)) {
+        return -WIN_SCORE;
+    }
+
+    m_arena = &SearchArena::local();
+    m_arena->board.load(board);
+    m_nodeCount = 0;
+    m_stopped = false;
+
+    // 与根节点展开这一步时完全相同：直接获胜记满分，否则交给对手继续搜索
+    m_arena->board.place(move, m_pieceType);
+    int score = WIN_SCORE;
+    if (!isWinningMove(move, m_pieceType)) {
+        score = minimax(1, m_maxDepth - 1, false).score;
+    }
+    m_arena->board.undo();
+
+    m_arena = nullptr;
+    return score;
+}
+
+int MinimaxSearch::depthForDifficulty(int difficulty)
+{
+    switch (difficulty) {
+        case 1: return 2;  // 简单
+        case 2: return 4;  // 中等
+        case 3: return 6;  // 困难
+        default: return 4;
+    }
+}
+
+MinimaxSearch::MoveScore MinimaxSearch::minimax(int ply, int depth, bool isMaximizing, int alpha, int beta)
+{
+    m_arena->pvLength[ply] = 0;
+    if (shouldStop()) {
+        return MoveScore();
+    }
+
+    SearchBoard& board = m_arena->board;
+
+    // 检查游戏结束或达到最大深度
+    if (depth == 0 || board.isFull()) {
+        return MoveScore(MoveIndex(), evaluateBoard());
+    }
+
+    MoveList& candidates = m_arena->lists[ply];
+    generateCandidateMoves(candidates);
+    if (candidates.count == 0) {
+        return MoveScore(MoveIndex(), evaluateBoard());
+    }
+
+    ChessBoard::PieceType currentPlayer = isMaximizing ? m_pieceType :
+        (m_pieceType == ChessBoard::Black ? ChessBoard::White : ChessBoard::Black);
+
+    MoveScore bestMove(MoveIndex(), isMaximizing ? INT_MIN : INT_MAX);
+
+    for (int i = 0; i < candidates.count; ++i) {
+        const MoveIndex move = candidates.moves[i];
+
+        // 尝试这一步
+        board.place(move, currentPlayer);
+
+        // 检查是否获胜
+        if (isWinningMove(move, currentPlayer)) {
+            board.undo();
+            m_arena->pv[ply][0] = move;
+            m_arena->pvLength[ply] = 1;
+            int score = isMaximizing ? WIN_SCORE : -WIN_SCORE;
+            if (ply == 0 && m_heatmap) {
+                m_heatmap->record(move, score, 1);
+            }
+            return MoveScore(move, score);
+        }
+
+        // 递归搜索
+        const quint64 nodesBefore = m_nodeCount;
+        MoveScore score = minimax(ply + 1, depth - 1, !isMaximizing, alpha, beta);
+
+        // 撤销这一步
+        board.undo();
+
+        // 被停止的子树结果不完整，不能参与比较
+        if (m_stopped) {
+            break;
+        }
+        if (ply == 0 && m_heatmap) {
+            m_heatmap->record(move, score.score, m_nodeCount - nodesBefore + 1);
+        }
+
+        if (isMaximizing) {
+            if (score.score > bestMove.score) {
+                bestMove = MoveScore(move, score.score);
+                updatePrincipalVariation(ply, move);
+            }
+            alpha = std::max(alpha, score.score);
+        } else {
+            if (score.score < bestMove.score) {
+                bestMove = MoveScore(move, score.score);
+                updatePrincipalVariation(ply, move);
+            }
+            beta = std::min(beta, score.score);
+        }
+
+        // Alpha-Beta剪枝
+        if (beta <= alpha) {
+            break;
+        }
+    }
+
+    return bestMove;
+}
+
+int MinimaxSearch::evaluateBoard() const
+{
+    const SearchBoard& board = m_arena->board;
+    return evaluate(board.lines, board.stones, board.stoneCount, m_pieceType);
+}
+
+int MinimaxSearch::evaluate(const LineBoard& lines, const MoveIndex* stones, int stoneCount,
+                            ChessBoard::PieceType perspective)
+{
+    int score = 0;
+
+    // 只需要评估已落下的棋子
+    for (int i = 0; i < stoneCount; ++i) {
+        const MoveIndex stone = stones[i];
+        ChessBoard::PieceType piece = static_cast<ChessBoard::PieceType>(lines.pieceAt(stone));
+        int posScore = evaluatePosition(lines, stone, piece);
+        score += (piece == perspective) ? posScore : -posScore;
+    }
+
+    return score;
+}
+
+int MinimaxSearch::evaluatePosition(const LineBoard& lines, MoveIndex move, ChessBoard::PieceType type)
+{
+    // 四个方向的连子和两端空位由位棋盘一次得出
+    LineBoard::LineRun runs[4];
+    lines.runsThrough(move, type, runs);
+
+    int score = 0;
+    for (const LineBoard::LineRun& run : runs) {
+        score += evaluateLine(run);
+    }
+    return score;
+}
+
+int MinimaxSearch::evaluateLine(const LineBoard::LineRun& run)
+{
+    const int count = run.length;            // 包含当前位置
+    const int emptyCount = run.openEnds;
+
+    // 根据连子数量和开放性评分
+    if (count >= 5) {
+        return WIN_SCORE;
+    } else if (count == 4) {
+        return emptyCount > 0 ? FOUR_SCORE : BLOCK_FOUR_SCORE;
+    } else if (count == 3) {
+        return emptyCount > 0 ? THREE_SCORE : BLOCK_THREE_SCORE;
+    } else if (count == 2) {
+        return emptyCount > 0 ? TWO_SCORE : 0;
+    } else {
+        return emptyCount > 0 ? ONE_SCORE : 0;
+    }
+}
+
+void MinimaxSearch::generateCandidateMoves(MoveList& list)
+{
+    const SearchBoard& board = m_arena->board;
+    MoveSet& seen = m_arena->seen;
+    qint32* keys = m_arena->sortKeys;
+    int count = 0;
+
+    seen.clear();
+
+    // 收集所有已下棋子周围两格内的空位置，同时计算排序用的分数
+    for (int i = 0; i < board.stoneCount; ++i) {
+        const MoveIndex stone = board.stones[i];
+        int rowBegin = std::max(0, stone.row() - 2);
+        int rowEnd = std::min(BOARD_SIZE - 1, stone.row() + 2);
+        int colBegin = std::max(0, stone.col() - 2);
+        int colEnd = std::min(BOARD_SIZE - 1, stone.col() + 2);
+
+        for (int row = rowBegin; row <= rowEnd; ++row) {
+            for (int col = colBegin; col <= colEnd; ++col) {
+                MoveIndex move = MoveIndex::fromRowCol(row, col);
+                if (board.cells[row][col] == ChessBoard::Empty && seen.testAndInsert(move)) {
+                    keys[count++] = (evaluatePosition(board.lines, move, m_pieceType) << 8) | move.value();
+                }
+            }
+        }
+    }
+
+    // 如果没有候选位置，返回中心附近的位置
+    if (count == 0) {
+        for (int row = 6; row <= 8; ++row) {
+            for (int col = 6; col <= 8; ++col) {
+                if (board.cells[row][col] == ChessBoard::Empty) {
+                    keys[count++] = MoveIndex::fromRowCol(row, col).value();
+                }
+            }
+        }
+    }
+
+    // 按重要性排序，并限制候选数量以提高性能
+    int keep = std::min(count, MAX_CANDIDATES);
+    std::partial_sort(keys, keys + keep, keys + count, [](qint32 a, qint32 b) {
+        return a > b;
+    });
+
+    for (int i = 0; i < keep; ++i) {
+        list.moves[i] = MoveIndex(static_cast<quint8>(keys[i] & 0xFF));
+    }
+    list.count = keep;
+}
+
+bool MinimaxSearch::isWinningMove(MoveIndex move, ChessBoard::PieceType type) const
+{
+    return m_arena->board.lines.fiveDirections(move, type) != 0;
+}
+
+void MinimaxSearch::updatePrincipalVariation(int ply, MoveIndex move)
+{
+    // 本层最佳着法 + 子节点的主变例
+    MoveIndex* line = m_arena->pv[ply];
+    const MoveIndex* childLine = m_arena->pv[ply + 1];
+    const int length = qMin(m_arena->pvLength[ply + 1] + 1, static_cast<int>(MAX_PLY));
+
+    line[0] = move;
+    for (int i = 1; i < length; ++i) {
+        line[i] = childLine[i - 1];
+    }
+    m_arena->pvLength[ply] = length;
+}
+
+bool MinimaxSearch::shouldStop()
+{
+    if (m_stopped) {
+        return true;
+    }
+
+    // 只每隔若干节点检查一次，避免频繁读取原子变量和时钟
+    if ((++m_nodeCount & (STOP_CHECK_INTERVAL - 1)) != 0) {
+        return false;
+    }
+
+    if ((m_stopFlag && m_stopFlag->load(std::memory_order_relaxed)) || m_deadline.hasExpired()) {
+        m_stopped = true;
+    }
+    return m_stopped;
+}
+
+// SearchBoard 实现
+void MinimaxSearch::SearchBoard::load(const ChessBoard* board)
+{
+    stoneCount = 0;
+    lines.clear();
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            ChessBoard::PieceType piece = board->pieceAt(row, col);
+            cells[row][col] = static_cast<quint8>(piece);
+            if (piece != ChessBoard::Empty) {
+                stones[stoneCount++] = MoveIndex::fromRowCol(row, col);
+                lines.place(MoveIndex::fromRowCol(row, col), piece);
+            }
+        }
+    }
+}
+
+ChessBoard::PieceType MinimaxSearch::SearchBoard::at(int row, int col) const
+{
+    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) {
+        return ChessBoard::Empty;
+    }
+    return static_cast<ChessBoard::PieceType>(cells[row][col]);
+}
+
+void MinimaxSearch::SearchBoard::place(MoveIndex move, ChessBoard::PieceType type)
+{
+    cells[move.row()][move.col()] = static_cast<quint8>(type);
+    stones[stoneCount++] = move;
+    lines.place(move, type);
+}
+
+void MinimaxSearch::SearchBoard::undo()
+{
+    MoveIndex move = stones[--stoneCount];
+    cells[move.row()][move.col()] = ChessBoard::Empty;
+    lines.remove(move);
+}
@@ -0,0 +1,143 @@
+#ifndef MINIMAXSEARCH_H
+#define MINIMAXSEARCH_H
+
+#include <QPoint>
+#include <QVector>
+#include <QDeadlineTimer>
+#include <atomic>
+#include <climits>
+#include "core/ChessBoard.h"
+#include "core/MoveIndex.h"
+#include "core/LineBoard.h"
+
+class SearchHeatmap;
+
+// Minimax搜索核心
+// 不依赖Player/信号槽，可以在任意工作线程中独立使用（每个线程一个实例）。
+// 搜索过程中的所有存储都来自每线程预分配的SearchArena，节点内不申请堆内存。
+class MinimaxSearch
+{
+public:
+    // 根节点的一个候选着法及其主变例
+    struct RootMove {
+        QPoint move;
+        int score;                  // 站在pieceType一方
+        QVector<QPoint> variation;  // 以move开头，双方交替的预期着法序列
+    };
+
+    explicit MinimaxSearch(ChessBoard::PieceType pieceType, int maxDepth = 4);
+
+    ChessBoard::PieceType pieceType() const { return m_pieceType; }
+    int maxDepth() const { return m_maxDepth; }
+    void setMaxDepth(int depth) { m_maxDepth = qBound(1, depth, MAX_PLY - 1); }
+
+    // 协作式取消：搜索每隔STOP_CHECK_INTERVAL个节点检查一次停止标志和截止时间
+    void setStopFlag(const std::atomic_bool* stop) { m_stopFlag = stop; }
+    void setDeadline(const QDeadlineTimer& deadline) { m_deadline = deadline; }
+    bool wasStopped() const { return m_stopped; }
+    // 可选：每搜完一个根节点着法把分数和子树节点数写入热力图
+    void setHeatmap(SearchHeatmap* heatmap) { m_heatmap = heatmap; }
+    quint64 nodeCount() const { return m_nodeCount; }
+
+    // 计算最佳落子位置；被中途停止时返回已完整搜索过的分支中的最佳位置
+    QPoint findBestMove(const ChessBoard* board);
+    // 上一次findBestMove得到的根节点分数（站在pieceType一方）
+    int lastScore() const { return m_lastScore; }
+
+    // 多主变例：一次搜索返回分数最高的count个着法（按分数从高到低），分数与findBestMove一致
+    QVector<RootMove> findTopMoves(const ChessBoard* board, int count);
+
+    // 以相同深度给指定落子打分，与findBestMove的根节点分数可直接比较
+    int scoreMove(const ChessBoard* board, const QPoint& position);
+
+    // 难度(1-3)到搜索深度的映射
+    static int depthForDifficulty(int difficulty);
+
+    // 静态局面评估（与搜索叶节点相同的评分），站在perspective一方，不依赖实例可并发调用
+    static int evaluate(const LineBoard& lines, const MoveIndex* stones, int stoneCount,
+                        ChessBoard::PieceType perspective);
+
+    static const int MAX_PLY = 16;
+
+private:
+    static const int BOARD_SIZE = ChessBoard::BOARD_SIZE;
+    static const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+    static const int MAX_CANDIDATES = 20;
+
+    struct MoveScore {
+        MoveIndex move;
+        int score;
+
+        MoveScore(MoveIndex m = MoveIndex(), int s = 0) : move(m), score(s) {}
+    };
+
+    // 搜索专用的紧凑棋盘：二维数组 + 棋子栈 + 按线位棋盘，落子/撤销都是O(1)
+    struct SearchBoard {
+        quint8 cells[BOARD_SIZE][BOARD_SIZE];
+        MoveIndex stones[CELL_COUNT];
+        int stoneCount;
+        LineBoard lines;
+
+        void load(const ChessBoard* board);
+        ChessBoard::PieceType at(int row, int col) const;
+        void place(MoveIndex move, ChessBoard::PieceType type);
+        void undo();
+        bool isFull() const { return stoneCount >= CELL_COUNT; }
+    };
+
+    // 每层搜索使用的定长候选列表（每个候选1字节）
+    struct MoveList {
+        MoveIndex moves[MAX_CANDIDATES];
+        int count;
+    };
+
+    // 每个线程预先分配一次的搜索内存
+    struct SearchArena {
+        SearchBoard board;
+        MoveList lists[MAX_PLY];
+        MoveSet seen;                    // 候选去重，替代QSet<QPoint>
+        qint32 sortKeys[CELL_COUNT];     // (分数 << 8) | 落子编码，排序用
+        MoveIndex pv[MAX_PLY + 1][MAX_PLY];  // 三角形主变例表，pv[ply]为从该层开始的最佳序列
+        int pvLength[MAX_PLY + 1];
+
+        static SearchArena& local();
+    };
+
+    MoveScore minimax(int ply, int depth, bool isMaximizing,
+                     int alpha = INT_MIN, int beta = INT_MAX);
+
+    int evaluateBoard() const;
+    static int evaluatePosition(const LineBoard& lines, MoveIndex move, ChessBoard::PieceType type);
+    static int evaluateLine(const LineBoard::LineRun& run);
+
+    void generateCandidateMoves(MoveList& list);
+    void updatePrincipalVariation(int ply, MoveIndex move);
+    bool isWinningMove(MoveIndex move, ChessBoard::PieceType type) const;
+    bool shouldStop();
+
+    ChessBoard::PieceType m_pieceType;
+    int m_maxDepth;
+    SearchArena* m_arena;
+
+    const std::atomic_bool* m_stopFlag;
+    QDeadlineTimer m_deadline;
+    quint64 m_nodeCount;
+    bool m_stopped;
+    int m_lastScore;
+    SearchHeatmap* m_heatmap;
+
+    // 必须是2的幂
+    static const quint64 STOP_CHECK_INTERVAL = 64;
+
+    // 评估权重
+    static const int WIN_SCORE = 1000000;
+    static const int BLOCK_WIN_SCORE = 100000;
+    static const int FOUR_SCORE = 10000;
+    static const int BLOCK_FOUR_SCORE = 1000;
+    static const int THREE_SCORE = 1000;
+    static const int BLOCK_THREE_SCORE = 100;
+    static const int TWO_SCORE = 100;
+    static const int ONE_SCORE = 10;
+};
+
+#endif // MINIMAXSEARCH_H
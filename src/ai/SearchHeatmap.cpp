@@ -0,0 +1,52 @@
+#include "SearchHeatmap.h"
+
+const int SearchHeatmap::CELL_COUNT;
+const qint32 SearchHeatmap::NO_SCORE;
+
+SearchHeatmap::SearchHeatmap()
+    : m_sequence(0)
+{
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        m_visits[i].store(0, std::memory_order_relaxed);
+        m_scores[i].store(NO_SCORE, std::memory_order_relaxed);
+    }
+}
+
+void SearchHeatmap::reset()
+{
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        m_visits[i].store(0, std::memory_order_relaxed);
+        m_scores[i].store(NO_SCORE, std::memory_order_relaxed);
+    }
+    m_sequence.fetch_add(1, std::memory_order_release);
+}
+
+void SearchHeatmap::record(MoveIndex move, int score, quint64 nodes)
+{
+    if (!move.isValid()) {
+        return;
+    }
+
+    // 单一写入者，读-改-写不需要原子指令
+    const int cell = move.value();
+    const quint32 visits = m_visits[cell].load(std::memory_order_relaxed);
+    const quint64 total = qMin<quint64>(quint64(visits) + nodes, 0xFFFFFFFFu);
+    m_visits[cell].store(static_cast<quint32>(total), std::memory_order_relaxed);
+    m_scores[cell].store(score, std::memory_order_relaxed);
+    m_sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool SearchHeatmap::snapshot(Snapshot* out, quint64 lastSequence) const
+{
+    const quint64 sequence = m_sequence.load(std::memory_order_acquire);
+    if (sequence == lastSequence) {
+        return false;
+    }
+
+    for (int i = 0; i < CELL_COUNT; ++i) {
+        out->visits[i] = m_visits[i].load(std::memory_order_relaxed);
+        out->scores[i] = m_scores[i].load(std::memory_order_relaxed);
+    }
+    out->sequence = sequence;
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SEARCHHEATMAP_H
+#define SEARCHHEATMAP_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <climits>
+#include "core/MoveIndex.h"
+
+// 搜索热力图的共享缓冲区
+// 搜索线程是唯一的写入者：每搜完一个根节点着法，记录它的分数和子树节点数，
+// 只做几次relaxed存储和一次release递增序号，不加锁也不等待读者。
+// 界面线程按固定帧率比较序号，有变化时才拷贝快照；快照可能跨越两次写入，
+// 对可视化来说无关紧要。
+class SearchHeatmap
+{
+public:
+    static const int CELL_COUNT = MoveIndex::CELL_COUNT;
+    static const qint32 NO_SCORE = INT_MIN;
+
+    struct Snapshot {
+        quint32 visits[CELL_COUNT];
+        qint32 scores[CELL_COUNT];      // 站在搜索一方，NO_SCORE表示尚未搜到
+        quint64 sequence;
+    };
+
+    SearchHeatmap();
+
+    // 以下两个函数只能由写入线程调用
+    void reset();
+    void record(MoveIndex move, int score, quint64 nodes);
+
+    // 任意线程调用；序号与lastSequence相同时返回false且不拷贝
+    bool snapshot(Snapshot* out, quint64 lastSequence) const;
+    quint64 sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<quint32> m_visits[CELL_COUNT];
+    std::atomic<qint32> m_scores[CELL_COUNT];
+    std::atomic<quint64> m_sequence;
+};
+
+#endif // SEARCHHEATMAP_H
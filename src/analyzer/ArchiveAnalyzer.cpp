@@ -0,0 +1,297 @@
+#include "ArchiveAnalyzer.h"
+#include "core/GameRule.h"
+#include "ai/MinimaxSearch.h"
+#include <QIODevice>
+#include <QTextStream>
+#include <QMutexLocker>
+#include <cmath>
+
+ArchiveAnalyzer::ArchiveAnalyzer(const Options& options)
+    : m_options(options)
+    , m_pool(options.threads)
+    , m_inFlight(qMax(1, options.maxInFlight))
+    , m_output(nullptr)
+    , m_nextOutput(0)
+    , m_invalidGames(0)
+    , m_analyzedMoves(0)
+{
+}
+
+ArchiveAnalyzer::~ArchiveAnalyzer()
+{
+    m_pool.waitForIdle();
+}
+
+ArchiveAnalyzer::Totals ArchiveAnalyzer::analyze(QIODevice* input, QTextStream* output)
+{
+    m_output = output;
+    m_nextOutput = 0;
+    m_finished.clear();
+    m_invalidGames = 0;
+    m_analyzedMoves = 0;
+
+    qint64 gameCount = 0;
+    for (;;) {
+        // readLine对管道同样阻塞等待，只有到达末尾时才返回空
+        QByteArray raw = input->readLine();
+        if (raw.isEmpty()) {
+            break;
+        }
+
+        QString line = QString::fromUtf8(raw).simplified();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        auto job = std::make_shared<GameJob>();
+        job->index = gameCount++;
+        job->validMoves = 0;
+        job->winner = ChessBoard::Empty;
+        job->draw = false;
+        job->remaining = 0;
+
+        const QStringList tokens = line.split(' ');
+        for (const QString& token : tokens) {
+            if (token.contains('=')) {
+                job->tags.append(token);
+                continue;
+            }
+            MoveIndex move = parseMove(token);
+            if (!move.isValid()) {
+                job->error = QString("bad move '%1'").arg(token);
+                break;
+            }
+            job->moves.append(move);
+        }
+
+        // 限制同时处理的对局数，读取速度不会远超分析速度
+        m_inFlight.acquire();
+        m_pool.submit([this, job]() { replayGame(job); });
+    }
+
+    m_pool.waitForIdle();
+
+    Totals totals;
+    totals.games = gameCount;
+    totals.invalidGames = m_invalidGames.load();
+    totals.analyzedMoves = m_analyzedMoves.load();
+    return totals;
+}
+
+void ArchiveAnalyzer::replayGame(const std::shared_ptr<GameJob>& job)
+{
+    ChessBoard board;
+    GameRule rule;
+
+    // 复盘校验，遇到非法落子截断，分出胜负或判和后忽略其余记录
+    for (int ply = 0; ply < job->moves.size(); ++ply) {
+        const QPoint position = job->moves[ply].toPoint();
+        const ChessBoard::PieceType piece = (ply % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+        if (!rule.isValidMove(position, &board)) {
+            if (job->error.isEmpty()) {
+                job->error = QString("illegal move %1 at ply %2").arg(formatMove(job->moves[ply])).arg(ply + 1);
+            }
+            break;
+        }
+
+        board.placePiece(position, piece);
+        job->validMoves++;
+        if (rule.checkWin(position, &board)) {
+            job->winner = piece;
+            break;
+        }
+        if (rule.isDraw(&board)) {
+            job->draw = true;
+            break;
+        }
+    }
+
+    if (m_options.staticEval) {
+        evaluatePositions(job.get());
+    }
+
+    job->results.resize(job->validMoves);
+    for (int ply = 0; ply < job->validMoves; ++ply) {
+        job->results[ply].played = job->moves[ply];
+        job->results[ply].best = MoveIndex();
+        job->results[ply].loss = 0;
+    }
+
+    // 第一步没有可比较的局面，从第二步开始分析
+    const int tasks = job->validMoves - 1;
+    if (tasks <= 0) {
+        finishGame(job);
+        return;
+    }
+
+    job->remaining = tasks;
+    for (int ply = 1; ply < job->validMoves; ++ply) {
+        m_pool.submit([this, job, ply]() { analyzeMove(job, ply); });
+    }
+}
+
+void ArchiveAnalyzer::evaluatePositions(GameJob* job) const
+{
+    // 逐手累积成连续的CompactPosition数组，一次交给批量评估器；分数统一站在黑方一边
+    QVector<CompactPosition> positions(job->validMoves);
+    CompactPosition position;
+    position.clear();
+    position.sideToMove = ChessBoard::Black;
+    LineBoard lines;
+    for (int side = 0; side < 2; ++side) {
+        job->patterns[side].resize(job->validMoves);
+    }
+    for (int ply = 0; ply < job->validMoves; ++ply) {
+        const ChessBoard::PieceType piece = (ply % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+        position.setPiece(job->moves[ply], piece);
+        positions[ply] = position;
+        lines.place(job->moves[ply], piece);
+        job->patterns[0][ply] = lines.scan(ChessBoard::Black);
+        job->patterns[1][ply] = lines.scan(ChessBoard::White);
+    }
+    job->evals = m_evaluator.evaluate(positions);
+}
+
+void ArchiveAnalyzer::analyzeMove(const std::shared_ptr<GameJob>& job, int ply)
+{
+    ChessBoard board;
+    for (int i = 0; i < ply; ++i) {
+        board.placePiece(job->moves[i].toPoint(), (i % 2 == 0) ? ChessBoard::Black : ChessBoard::White);
+    }
+
+    const ChessBoard::PieceType side = (ply % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+    MinimaxSearch search(side, m_options.depth);
+    MoveResult& result = job->results[ply];
+    result.best = MoveIndex::fromPoint(search.findBestMove(&board));
+
+    if (result.best != result.played) {
+        const int bestScore = search.lastScore();
+        const int playedScore = search.scoreMove(&board, result.played.toPoint());
+        // 根节点只展开有限个候选，实际落子可能比推荐着法更好，此时记为无损失
+        result.loss = qMax(0, bestScore - playedScore);
+    }
+
+    m_analyzedMoves++;
+    if (job->remaining.fetch_sub(1) == 1) {
+        finishGame(job);
+    }
+}
+
+void ArchiveAnalyzer::finishGame(const std::shared_ptr<GameJob>& job)
+{
+    if (!job->error.isEmpty()) {
+        m_invalidGames++;
+    }
+    const QString line = summarize(*job);
+
+    QMutexLocker locker(&m_outputMutex);
+    m_finished.insert(job->index, line);
+    while (!m_finished.isEmpty() && m_finished.firstKey() == m_nextOutput) {
+        *m_output << m_finished.take(m_nextOutput) << '\n';
+        m_nextOutput++;
+        m_inFlight.release();
+    }
+    m_output->flush();
+}
+
+QString ArchiveAnalyzer::summarize(const GameJob& job) const
+{
+    int moves[2] = { 0, 0 };
+    int bestMatches[2] = { 0, 0 };
+    double accuracy[2] = { 0.0, 0.0 };
+    qint64 loss[2] = { 0, 0 };
+
+    for (int ply = 1; ply < job.results.size(); ++ply) {
+        const MoveResult& result = job.results[ply];
+        const int side = ply % 2;
+        moves[side]++;
+        loss[side] += result.loss;
+        accuracy[side] += moveAccuracy(result.loss);
+        if (result.best == result.played) {
+            bestMatches[side]++;
+        }
+    }
+
+    QString resultText = "unfinished";
+    if (job.winner == ChessBoard::Black) {
+        resultText = "black";
+    } else if (job.winner == ChessBoard::White) {
+        resultText = "white";
+    } else if (job.draw) {
+        resultText = "draw";
+    }
+
+    QStringList parts;
+    parts << QString("#%1").arg(job.index + 1);
+    parts << job.tags;
+    parts << QString("moves=%1").arg(job.validMoves);
+    parts << QString("result=%1").arg(resultText);
+
+    const char* sideNames[2] = { "black", "white" };
+    for (int side = 0; side < 2; ++side) {
+        if (moves[side] == 0) {
+            parts << QString("%1(acc=- loss=- best=0/0)").arg(sideNames[side]);
+            continue;
+        }
+        parts << QString("%1(acc=%2% loss=%3 best=%4/%5)")
+                     .arg(sideNames[side])
+                     .arg(accuracy[side] / moves[side], 0, 'f', 1)
+                     .arg(loss[side] / moves[side])
+                     .arg(bestMatches[side])
+                     .arg(moves[side]);
+    }
+
+    if (!job.evals.isEmpty()) {
+        QStringList scores;
+        scores.reserve(job.evals.size());
+        for (qint32 score : job.evals) {
+            scores << QString::number(score);
+        }
+        parts << QString("eval=%1").arg(scores.join(','));
+
+        // 每手一项：黑方活四/冲四点/活三/白方活四/冲四点/活三
+        QStringList threats;
+        threats.reserve(job.evals.size());
+        for (int ply = 0; ply < job.evals.size(); ++ply) {
+            const LineBoard::PatternCounts& black = job.patterns[0][ply];
+            const LineBoard::PatternCounts& white = job.patterns[1][ply];
+            threats << QString("%1/%2/%3/%4/%5/%6")
+                           .arg(black.openFours).arg(black.fours).arg(black.openThrees)
+                           .arg(white.openFours).arg(white.fours).arg(white.openThrees);
+        }
+        parts << QString("threats=%1").arg(threats.join(','));
+    }
+
+    if (!job.error.isEmpty()) {
+        parts << QString("error=\"%1\"").arg(job.error);
+    }
+    return parts.join(' ');
+}
+
+double ArchiveAnalyzer::moveAccuracy(qint32 loss)
+{
+    return 100.0 * std::exp(-static_cast<double>(loss) / LOSS_SCALE);
+}
+
+MoveIndex ArchiveAnalyzer::parseMove(const QString& token)
+{
+    if (token.size() < 2) {
+        return MoveIndex();
+    }
+
+    const int col = token.at(0).toLower().unicode() - 'a';
+    bool ok = false;
+    const int row = token.midRef(1).toInt(&ok) - 1;
+    if (!ok) {
+        return MoveIndex();
+    }
+    return MoveIndex::fromRowCol(row, col);
+}
+
+QString ArchiveAnalyzer::formatMove(MoveIndex move)
+{
+    if (!move.isValid()) {
+        return QString("-");
+    }
+    return QString("%1%2").arg(QChar('a' + move.col())).arg(move.row() + 1);
+}
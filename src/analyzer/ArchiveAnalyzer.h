@@ -0,0 +1,108 @@
+#ifndef ARCHIVEANALYZER_H
+#define ARCHIVEANALYZER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QMutex>
+#include <QSemaphore>
+#include <atomic>
+#include <memory>
+#include "core/ChessBoard.h"
+#include "core/MoveIndex.h"
+#include "core/LineBoard.h"
+#include "ai/BatchEvaluator.h"
+#include "WorkStealingPool.h"
+
+class QIODevice;
+class QTextStream;
+
+// 对局档案分析
+// 逐行读取对局记录，用ChessBoard/GameRule复盘校验，再对每一步求引擎推荐着法和该步的分数损失，
+// 按对局输出双方的准确率汇总。
+//
+// 记录格式：每行一局，空行和以#开头的行忽略。
+// 形如 key=value 的记号是对局标签（例如 black=张三 white=李四），原样输出；
+// 其余记号为落子，列用字母a-o、行用数字1-15，例如 h8 i9 h9。
+//
+// 每局的复盘是一个任务，复盘后的每一步分析再拆成子任务放进当前线程的队列，
+// 空闲线程通过工作窃取分担长对局。结果按输入顺序输出。
+// 开启staticEval时，每局复盘后把各手之后的局面交给BatchEvaluator批量静态评估，
+// 以eval=的形式附上黑方视角的局面分曲线，并以threats=附上LineBoard::scan得到的双方整盘棋型，供数据集任务使用。
+class ArchiveAnalyzer
+{
+public:
+    struct Options {
+        int depth;          // 搜索深度
+        int threads;        // 工作线程数
+        int maxInFlight;    // 同时在处理中的最大对局数，限制内存占用
+        bool staticEval;    // 输出每一手之后的静态评估分
+
+        Options() : depth(4), threads(1), maxInFlight(64), staticEval(false) {}
+    };
+
+    struct Totals {
+        qint64 games;
+        qint64 invalidGames;
+        qint64 analyzedMoves;
+    };
+
+    explicit ArchiveAnalyzer(const Options& options);
+    ~ArchiveAnalyzer();
+
+    // 流式分析input中的全部对局，每局一行汇总写入output
+    Totals analyze(QIODevice* input, QTextStream* output);
+
+    // 解析 h8 形式的坐标，失败返回无效的MoveIndex
+    static MoveIndex parseMove(const QString& token);
+    static QString formatMove(MoveIndex move);
+
+private:
+    struct MoveResult {
+        MoveIndex played;
+        MoveIndex best;
+        qint32 loss;
+    };
+
+    struct GameJob {
+        qint64 index;
+        QStringList tags;
+        QVector<MoveIndex> moves;
+        QString error;
+        int validMoves;
+        ChessBoard::PieceType winner;
+        bool draw;          // 棋盘下满或双方都已无法连成五子，与引擎判和一致
+        QVector<MoveResult> results;
+        QVector<qint32> evals;
+        QVector<LineBoard::PatternCounts> patterns[2];    // 每一手之后黑、白双方的整盘棋型
+        std::atomic_int remaining;
+    };
+
+    void replayGame(const std::shared_ptr<GameJob>& job);
+    void evaluatePositions(GameJob* job) const;
+    void analyzeMove(const std::shared_ptr<GameJob>& job, int ply);
+    void finishGame(const std::shared_ptr<GameJob>& job);
+    QString summarize(const GameJob& job) const;
+
+    static double moveAccuracy(qint32 loss);
+
+    Options m_options;
+    WorkStealingPool m_pool;
+    BatchEvaluator m_evaluator;
+    QSemaphore m_inFlight;
+
+    // 按输入顺序输出
+    QMutex m_outputMutex;
+    QTextStream* m_output;
+    QMap<qint64, QString> m_finished;
+    qint64 m_nextOutput;
+
+    std::atomic<qint64> m_invalidGames;
+    std::atomic<qint64> m_analyzedMoves;
+
+    // 损失到单步准确率的换算尺度：损失一个活三的分值时约为37%
+    static const int LOSS_SCALE = 1000;
+};
+
+#endif // ARCHIVEANALYZER_H
@@ -0,0 +1,125 @@
+#include "WorkStealingPool.h"
+#include <QThread>
+#include <QMutexLocker>
+
+namespace {
+thread_local int t_workerIndex = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_queued(0)
+    , m_pending(0)
+    , m_nextQueue(0)
+    , m_stopping(false)
+{
+    threadCount = qMax(1, threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        m_queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(QThread::create([this, i]() { run(i); }));
+        m_threads.back()->start();
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    waitForIdle();
+
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    for (auto& thread : m_threads) {
+        thread->wait();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    int index = t_workerIndex;
+    if (index < 0) {
+        index = static_cast<int>(m_nextQueue.fetch_add(1) % m_queues.size());
+    }
+
+    m_pending.fetch_add(1);
+    {
+        QMutexLocker locker(&m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1);
+
+    // 在m_sleepMutex下唤醒，与工作线程入睡前的再次检查配合，避免丢失唤醒
+    QMutexLocker locker(&m_sleepMutex);
+    m_wake.wakeOne();
+}
+
+void WorkStealingPool::waitForIdle()
+{
+    QMutexLocker locker(&m_sleepMutex);
+    while (m_pending.load() > 0) {
+        m_idle.wait(&m_sleepMutex);
+    }
+}
+
+int WorkStealingPool::currentWorker()
+{
+    return t_workerIndex;
+}
+
+void WorkStealingPool::run(int index)
+{
+    t_workerIndex = index;
+
+    for (;;) {
+        Task task;
+        if (popLocal(index, &task) || steal(index, &task)) {
+            m_queued.fetch_sub(1);
+            task();
+            task = nullptr;
+
+            if (m_pending.fetch_sub(1) == 1) {
+                QMutexLocker locker(&m_sleepMutex);
+                m_idle.wakeAll();
+            }
+            continue;
+        }
+
+        QMutexLocker locker(&m_sleepMutex);
+        if (m_queued.load() > 0) {
+            continue;
+        }
+        if (m_stopping) {
+            return;
+        }
+        m_wake.wait(&m_sleepMutex);
+    }
+}
+
+bool WorkStealingPool::popLocal(int index, Task* task)
+{
+    WorkerQueue& queue = *m_queues[index];
+    QMutexLocker locker(&queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task* task)
+{
+    const int count = static_cast<int>(m_queues.size());
+    for (int offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *m_queues[(thief + offset) % count];
+        QMutexLocker locker(&victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class QThread;
+
+// 工作窃取线程池
+// 每个工作线程有自己的任务双端队列：自己从尾部取（后进先出，缓存友好），
+// 空闲线程从其他线程队列的头部偷取较早提交、粒度较大的任务。
+// 在工作线程内提交的子任务进入当前线程的队列，外部线程提交的任务轮流分配到各队列。
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threadCount);
+    ~WorkStealingPool();
+
+    void submit(Task task);
+
+    // 阻塞直到所有已提交的任务（包括任务中派生的子任务）执行完毕
+    void waitForIdle();
+
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+    // 当前线程在池中的编号，不是池内线程时返回-1
+    static int currentWorker();
+
+private:
+    struct WorkerQueue {
+        QMutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int index);
+    bool popLocal(int index, Task* task);
+    bool steal(int thief, Task* task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+
+    QMutex m_sleepMutex;
+    QWaitCondition m_wake;      // 有新任务
+    QWaitCondition m_idle;      // 全部任务完成
+
+    std::atomic_int m_queued;   // 队列中尚未被取走的任务数
+    std::atomic_int m_pending;  // 已提交但尚未执行完的任务数
+    std::atomic_uint m_nextQueue;
+    bool m_stopping;
+};
+
+#endif // WORKSTEALINGPOOL_H
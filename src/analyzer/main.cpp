@@ -0,0 +1,90 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <cstdio>
+
+#include "analyzer/ArchiveAnalyzer.h"
+#include "ai/MinimaxSearch.h"
+#include "core/LineBoard.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("GobangAnalyzer");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("五子棋对局档案分析：逐步比较引擎推荐着法，输出每局双方准确率");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("archive", "对局记录文件，每行一局；省略或为 - 时从标准输入读取");
+
+    QCommandLineOption depthOption({"d", "depth"}, "搜索深度", "depth", "4");
+    QCommandLineOption threadsOption({"t", "threads"}, "工作线程数", "count",
+                                     QString::number(qMax(1, QThread::idealThreadCount())));
+    QCommandLineOption outputOption({"o", "output"}, "结果输出文件（默认标准输出）", "file");
+    QCommandLineOption evalOption({"e", "eval"}, "附加每一手之后的静态评估分（黑方视角）");
+    parser.addOption(depthOption);
+    parser.addOption(threadsOption);
+    parser.addOption(outputOption);
+    parser.addOption(evalOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+
+    QFile input;
+    const QStringList arguments = parser.positionalArguments();
+    const QString inputPath = arguments.isEmpty() ? QString("-") : arguments.first();
+    bool opened = false;
+    if (inputPath == "-") {
+        opened = input.open(stdin, QIODevice::ReadOnly);
+    } else {
+        input.setFileName(inputPath);
+        opened = input.open(QIODevice::ReadOnly);
+    }
+    if (!opened) {
+        err << "无法打开对局记录: " << inputPath << '\n';
+        return 1;
+    }
+
+    QFile outputFile;
+    bool outputOpened = false;
+    if (parser.isSet(outputOption)) {
+        outputFile.setFileName(parser.value(outputOption));
+        outputOpened = outputFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    } else {
+        outputOpened = outputFile.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!outputOpened) {
+        err << "无法写入结果: " << parser.value(outputOption) << '\n';
+        return 1;
+    }
+    QTextStream output(&outputFile);
+    output.setCodec("UTF-8");
+
+    ArchiveAnalyzer::Options options;
+    options.depth = qBound(1, parser.value(depthOption).toInt(), MinimaxSearch::MAX_PLY - 1);
+    options.threads = qMax(1, parser.value(threadsOption).toInt());
+    options.maxInFlight = options.threads * 8;
+    options.staticEval = parser.isSet(evalOption);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ArchiveAnalyzer analyzer(options);
+    ArchiveAnalyzer::Totals totals = analyzer.analyze(&input, &output);
+
+    const double seconds = timer.elapsed() / 1000.0;
+    err << QString("共 %1 局（%2 局记录有误），分析 %3 步，用时 %4 秒，%5 线程，棋型扫描 %6\n")
+               .arg(totals.games)
+               .arg(totals.invalidGames)
+               .arg(totals.analyzedMoves)
+               .arg(seconds, 0, 'f', 2)
+               .arg(options.threads)
+               .arg(LineBoard::simdPath());
+
+    return 0;
+}
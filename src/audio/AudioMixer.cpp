@@ -0,0 +1,397 @@
+#include "AudioMixer.h"
+#include "MusicStream.h"
+#include <QThread>
+#include <QTimer>
+#include <QIODevice>
+#include <QAudioOutput>
+#include <QAudioDeviceInfo>
+#include <QSysInfo>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+const int AudioMixer::MAX_VOICES;
+const int AudioMixer::PREFERRED_SAMPLE_RATE;
+const int AudioMixer::BUFFER_FRAMES;
+
+namespace {
+// 每次混音最多处理的帧数，输出设备一次要得更多时分块混音
+const int MIX_CHUNK_FRAMES = 1024;
+// 回收已经播完的音乐流的间隔
+const int RECLAIM_INTERVAL_MS = 250;
+}
+
+// QAudioOutput以拉模式从这个设备读数据，每次读都现场混音
+class AudioMixer::OutputDevice : public QIODevice
+{
+public:
+    explicit OutputDevice(AudioMixer* mixer) : m_mixer(mixer) {}
+
+    bool isSequential() const override { return true; }
+
+    qint64 bytesAvailable() const override
+    {
+        // 混音器总能产出数据（没有声音时就是静音）
+        return BUFFER_FRAMES * m_mixer->m_format.bytesPerFrame() + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        const int bytesPerFrame = m_mixer->m_format.bytesPerFrame();
+        qint64 written = 0;
+        while (maxSize - written >= bytesPerFrame) {
+            const int frames = static_cast<int>(qMin<qint64>(MIX_CHUNK_FRAMES, (maxSize - written) / bytesPerFrame));
+            m_mixer->render(m_mixer->m_mixBuffer.data(), frames);
+            m_mixer->writeOutput(m_mixer->m_mixBuffer.constData(), frames, data + written);
+            written += static_cast<qint64>(frames) * bytesPerFrame;
+        }
+        return written;
+    }
+
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+private:
+    AudioMixer* m_mixer;
+};
+
+AudioMixer::AudioMixer(QObject* parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_device(nullptr)
+    , m_output(nullptr)
+    , m_running(false)
+    , m_effectGain(1.0f)
+    , m_musicGain(1.0f)
+    , m_musicPaused(false)
+    , m_reclaimTimer(new QTimer(this))
+    , m_voiceCount(0)
+    , m_voiceOrder(0)
+    , m_music{}
+    , m_appliedMusicGain(1.0f)
+{
+    m_reclaimTimer->setInterval(RECLAIM_INTERVAL_MS);
+    connect(m_reclaimTimer, &QTimer::timeout, this, &AudioMixer::reclaimStreams);
+
+    m_format.setSampleRate(PREFERRED_SAMPLE_RATE);
+    m_format.setChannelCount(PcmCodec::CHANNELS);
+    m_format.setCodec("audio/pcm");
+    m_format.setByteOrder(QSysInfo::ByteOrder == QSysInfo::LittleEndian ? QAudioFormat::LittleEndian
+                                                                        : QAudioFormat::BigEndian);
+    m_format.setSampleType(QAudioFormat::Float);
+    m_format.setSampleSize(32);
+}
+
+AudioMixer::~AudioMixer()
+{
+    stop();
+}
+
+bool AudioMixer::start()
+{
+    if (m_running) {
+        return true;
+    }
+
+    const QAudioDeviceInfo device = QAudioDeviceInfo::defaultOutputDevice();
+    if (device.isNull()) {
+        qDebug() << "No audio output device available";
+        return false;
+    }
+
+    // 优先浮点输出，其次16位整数，都不支持时取设备最接近的格式
+    QAudioFormat format = m_format;
+    if (!device.isFormatSupported(format)) {
+        format.setSampleType(QAudioFormat::SignedInt);
+        format.setSampleSize(16);
+        if (!device.isFormatSupported(format)) {
+            format = device.nearestFormat(format);
+        }
+    }
+    const bool sampleTypeSupported = (format.sampleType() == QAudioFormat::Float && format.sampleSize() == 32)
+                                  || (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 16);
+    if (format.codec() != "audio/pcm" || !sampleTypeSupported
+        || format.channelCount() < 1 || format.channelCount() > PcmCodec::CHANNELS
+        || format.byteOrder() != m_format.byteOrder()) {
+        qDebug() << "Unsupported audio output format:" << format;
+        return false;
+    }
+    m_format = format;
+
+    m_mixBuffer.fill(0.0f, MIX_CHUNK_FRAMES * PcmCodec::CHANNELS);
+    m_musicBuffer.fill(0.0f, MIX_CHUNK_FRAMES * PcmCodec::CHANNELS);
+    m_voiceCount = 0;
+    m_music[0] = m_music[1] = MusicVoice{};
+    m_appliedMusicGain = m_musicGain.load();
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName("AudioMixer");
+    m_thread->start(QThread::TimeCriticalPriority);
+
+    m_device = new OutputDevice(this);
+    m_device->moveToThread(m_thread);
+
+    // QAudioOutput需要在混音线程里创建，它的回调才会在这个线程执行
+    bool started = false;
+    QMetaObject::invokeMethod(m_device, [this, device, &started]() {
+        m_device->open(QIODevice::ReadOnly);
+        m_output = new QAudioOutput(device, m_format, m_device);
+        m_output->setBufferSize(BUFFER_FRAMES * m_format.bytesPerFrame());
+        m_output->start(m_device);
+        started = (m_output->error() == QAudio::NoError);
+    }, Qt::BlockingQueuedConnection);
+
+    m_running = true;
+    if (!started) {
+        qDebug() << "Failed to start audio output";
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void AudioMixer::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_device, [this]() {
+        if (m_output) {
+            m_output->stop();
+            delete m_output;
+            m_output = nullptr;
+        }
+        m_device->close();
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread->quit();
+    m_thread->wait();
+    delete m_device;
+    m_device = nullptr;
+    delete m_thread;
+    m_thread = nullptr;
+    m_running = false;
+
+    // 混音线程已经退出，剩下的命令和音乐流都可以在这里直接清理
+    Command command;
+    while (m_commands.pop(&command)) {
+    }
+    MusicStream* retired;
+    while (m_retiredStreams.pop(&retired)) {
+    }
+    m_music[0] = m_music[1] = MusicVoice{};
+    qDeleteAll(m_streams);
+    m_streams.clear();
+    m_reclaimTimer->stop();
+}
+
+int AudioMixer::addSample(const PcmBuffer& pcm)
+{
+    m_samples.append(std::make_shared<const PcmBuffer>(pcm));
+    return m_samples.size() - 1;
+}
+
+bool AudioMixer::hasSample(int sampleId) const
+{
+    return sampleId >= 0 && sampleId < m_samples.size() && !m_samples[sampleId]->isEmpty();
+}
+
+void AudioMixer::play(int sampleId, float gain)
+{
+    if (!m_running || !hasSample(sampleId)) {
+        return;
+    }
+    // 队列满说明混音线程已经跟不上了，丢掉这次触发比阻塞界面线程好
+    m_commands.push(Command{Command::Play, m_samples[sampleId].get(), gain, nullptr, 0});
+}
+
+void AudioMixer::stopAll()
+{
+    if (m_running) {
+        m_commands.push(Command{Command::StopAll, nullptr, 0.0f, nullptr, 0});
+    }
+}
+
+void AudioMixer::setEffectGain(float gain)
+{
+    m_effectGain.store(qBound(0.0f, gain, 1.0f), std::memory_order_relaxed);
+}
+
+bool AudioMixer::playMusic(const QString& path, bool loop, int crossfadeMs)
+{
+    if (!m_running) {
+        return false;
+    }
+
+    MusicStream* stream = new MusicStream(path, sampleRate(), loop);
+    const int fadeFrames = crossfadeMs * sampleRate() / 1000;
+    if (!stream->start() || !m_commands.push(Command{Command::PlayMusic, nullptr, 0.0f, stream, fadeFrames})) {
+        delete stream;
+        return false;
+    }
+    m_streams.append(stream);
+    m_reclaimTimer->start();
+    return true;
+}
+
+void AudioMixer::stopMusic(int fadeMs)
+{
+    if (m_running && !m_streams.isEmpty()) {
+        m_commands.push(Command{Command::StopMusic, nullptr, 0.0f, nullptr, fadeMs * sampleRate() / 1000});
+    }
+}
+
+void AudioMixer::setMusicPaused(bool paused)
+{
+    m_musicPaused.store(paused, std::memory_order_relaxed);
+}
+
+void AudioMixer::setMusicGain(float gain)
+{
+    m_musicGain.store(qBound(0.0f, gain, 1.0f), std::memory_order_relaxed);
+}
+
+void AudioMixer::reclaimStreams()
+{
+    MusicStream* stream;
+    while (m_retiredStreams.pop(&stream)) {
+        m_streams.removeOne(stream);
+        delete stream;
+    }
+    if (m_streams.isEmpty()) {
+        m_reclaimTimer->stop();
+    }
+}
+
+void AudioMixer::processCommands()
+{
+    Command command;
+    while (m_commands.pop(&command)) {
+        switch (command.type) {
+            case Command::Play: {
+                int slot = m_voiceCount;
+                if (m_voiceCount < MAX_VOICES) {
+                    ++m_voiceCount;
+                } else {
+                    // 发声数已满时挤掉最早开始的声音
+                    slot = 0;
+                    for (int i = 1; i < MAX_VOICES; ++i) {
+                        if (m_voices[i].order < m_voices[slot].order) {
+                            slot = i;
+                        }
+                    }
+                }
+                m_voices[slot] = Voice{command.sample, 0, command.gain, m_voiceOrder++};
+                break;
+            }
+            case Command::StopAll:
+                m_voiceCount = 0;
+                break;
+            case Command::PlayMusic: {
+                // 只保留两首做交叉淡化，还在淡出的更早一首直接结束
+                const float step = 1.0f / qMax(1, command.fadeFrames);
+                retireMusic(&m_music[1]);
+                m_music[1] = m_music[0];
+                m_music[1].fadeStep = -step;
+                m_music[0] = MusicVoice{command.stream, 0.0f, step};
+                break;
+            }
+            case Command::StopMusic:
+                for (MusicVoice& voice : m_music) {
+                    voice.fadeStep = -1.0f / qMax(1, command.fadeFrames);
+                }
+                break;
+        }
+    }
+}
+
+void AudioMixer::render(float* output, int frames)
+{
+    processCommands();
+
+    const int sampleCount = frames * PcmCodec::CHANNELS;
+    std::fill(output, output + sampleCount, 0.0f);
+    renderMusic(output, frames);
+
+    const float effectGain = m_effectGain.load(std::memory_order_relaxed);
+    int index = 0;
+    while (index < m_voiceCount) {
+        Voice& voice = m_voices[index];
+        const int count = qMin(voice.sample->frames - voice.position, frames) * PcmCodec::CHANNELS;
+        const float gain = voice.gain * effectGain;
+        const float* source = voice.sample->samples.constData() + voice.position * PcmCodec::CHANNELS;
+        for (int i = 0; i < count; ++i) {
+            output[i] += source[i] * gain;
+        }
+        voice.position += count / PcmCodec::CHANNELS;
+
+        if (voice.position >= voice.sample->frames) {
+            m_voices[index] = m_voices[--m_voiceCount];
+        } else {
+            ++index;
+        }
+    }
+}
+
+void AudioMixer::renderMusic(float* output, int frames)
+{
+    const float targetGain = m_musicGain.load(std::memory_order_relaxed);
+    if (m_musicPaused.load(std::memory_order_relaxed)) {
+        // 暂停时不从流里取数据，解码线程会因为缓冲写满而停下
+        m_appliedMusicGain = targetGain;
+        return;
+    }
+
+    // 音量在一个缓冲内线性过渡到新值，避免突变产生爆音
+    const float gainStep = (targetGain - m_appliedMusicGain) / frames;
+    for (MusicVoice& voice : m_music) {
+        if (!voice.stream) {
+            continue;
+        }
+        const int count = voice.stream->read(m_musicBuffer.data(), frames);
+        const float* source = m_musicBuffer.constData();
+        float gain = m_appliedMusicGain;
+        for (int i = 0; i < count; ++i) {
+            voice.fade = qBound(0.0f, voice.fade + voice.fadeStep, 1.0f);
+            gain += gainStep;
+            output[2 * i] += source[2 * i] * gain * voice.fade;
+            output[2 * i + 1] += source[2 * i + 1] * gain * voice.fade;
+        }
+        if ((voice.fadeStep < 0.0f && voice.fade <= 0.0f) || voice.stream->isFinished()) {
+            retireMusic(&voice);
+        }
+    }
+    m_appliedMusicGain = targetGain;
+}
+
+void AudioMixer::retireMusic(MusicVoice* voice)
+{
+    if (voice->stream) {
+        // 交还失败只会让这个流留到混音器停止时再删除
+        m_retiredStreams.push(voice->stream);
+        voice->stream = nullptr;
+    }
+}
+
+void AudioMixer::writeOutput(const float* mix, int frames, char* data) const
+{
+    const bool mono = (m_format.channelCount() == 1);
+    const bool floatOutput = (m_format.sampleType() == QAudioFormat::Float);
+    const int outputChannels = mono ? 1 : PcmCodec::CHANNELS;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const float* in = mix + frame * PcmCodec::CHANNELS;
+        for (int channel = 0; channel < outputChannels; ++channel) {
+            const float value = qBound(-1.0f, mono ? (in[0] + in[1]) * 0.5f : in[channel], 1.0f);
+            if (floatOutput) {
+                std::memcpy(data, &value, sizeof(value));
+                data += sizeof(value);
+            } else {
+                const qint16 sample = static_cast<qint16>(qRound(value * 32767.0f));
+                std::memcpy(data, &sample, sizeof(sample));
+                data += sizeof(sample);
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QObject>
+#include <QVector>
+#include <QAudioFormat>
+#include <atomic>
+#include <memory>
+#include "LockFreeQueue.h"
+#include "PcmCodec.h"
+
+class QThread;
+class QTimer;
+class QAudioOutput;
+class MusicStream;
+
+// 进程内混音器
+// 样本在界面线程预先解码并注册，之后播放只是往无锁队列里压一条命令；
+// 混音在独立的高优先级线程里进行，由QAudioOutput以拉模式按约5毫秒的缓冲取数据，
+// 触发到出声的延迟不超过一个缓冲周期加上驱动延迟。
+// 背景音乐由MusicStream在各自的线程解码，混音器从它们的环形缓冲读取，换曲时交叉淡化。
+class AudioMixer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_VOICES = 16;
+    static const int PREFERRED_SAMPLE_RATE = 48000;
+    static const int BUFFER_FRAMES = 256;
+
+    explicit AudioMixer(QObject* parent = nullptr);
+    ~AudioMixer();
+
+    // 打开默认输出设备并启动混音线程，没有可用设备时返回false
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // 样本需要解码到这个采样率，start()之前返回首选采样率
+    int sampleRate() const { return m_format.sampleRate(); }
+
+    // 注册一个已解码的样本，返回样本编号；样本在混音器销毁前一直有效
+    int addSample(const PcmBuffer& pcm);
+    bool hasSample(int sampleId) const;
+
+    // 以下函数只能在界面线程调用，都不会阻塞
+    void play(int sampleId, float gain = 1.0f);
+    void stopAll();
+    void setEffectGain(float gain);
+
+    // 背景音乐，同样只能在界面线程调用；音量和暂停在下一个缓冲周期生效
+    bool playMusic(const QString& path, bool loop, int crossfadeMs);
+    void stopMusic(int fadeMs);
+    void setMusicPaused(bool paused);
+    void setMusicGain(float gain);
+
+private slots:
+    void reclaimStreams();
+
+private:
+    class OutputDevice;
+    friend class OutputDevice;
+
+    struct Command {
+        enum Type { Play, StopAll, PlayMusic, StopMusic };
+        Type type;
+        const PcmBuffer* sample;
+        float gain;
+        MusicStream* stream;
+        int fadeFrames;
+    };
+
+    struct Voice {
+        const PcmBuffer* sample;
+        int position;
+        float gain;
+        quint64 order;
+    };
+
+    struct MusicVoice {
+        MusicStream* stream;
+        float fade;
+        float fadeStep;
+    };
+
+    // 以下在混音线程中执行
+    void render(float* output, int frames);
+    void processCommands();
+    void renderMusic(float* output, int frames);
+    void retireMusic(MusicVoice* voice);
+    void writeOutput(const float* mix, int frames, char* data) const;
+
+    QAudioFormat m_format;
+    QThread* m_thread;
+    OutputDevice* m_device;
+    QAudioOutput* m_output;
+    bool m_running;
+
+    QVector<std::shared_ptr<const PcmBuffer>> m_samples;
+
+    LockFreeQueue<Command, 256> m_commands;
+    std::atomic<float> m_effectGain;
+    std::atomic<float> m_musicGain;
+    std::atomic_bool m_musicPaused;
+
+    // 界面线程持有全部音乐流，混音线程用完后经m_retiredStreams交还再删除
+    QVector<MusicStream*> m_streams;
+    LockFreeQueue<MusicStream*, 16> m_retiredStreams;
+    QTimer* m_reclaimTimer;
+
+    // 只由混音线程访问
+    Voice m_voices[MAX_VOICES];
+    int m_voiceCount;
+    quint64 m_voiceOrder;
+    // 0是当前曲目，1是交叉淡化中正在淡出的上一首
+    MusicVoice m_music[2];
+    float m_appliedMusicGain;
+    QVector<float> m_mixBuffer;
+    QVector<float> m_musicBuffer;
+};
+
+#endif // AUDIOMIXER_H
@@ -0,0 +1,50 @@
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者无锁环形队列
+// 容量固定为Capacity-1个元素（Capacity必须是2的幂），满时push返回false而不是等待，
+// 两端都不会阻塞，适合界面线程向音频线程发送命令。
+template <typename T, std::size_t Capacity>
+class LockFreeQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    LockFreeQueue() : m_head(0), m_tail(0) {}
+
+    // 只能由生产者线程调用
+    bool push(const T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & (Capacity - 1);
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_items[tail] = value;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由消费者线程调用
+    bool pop(T* value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *value = m_items[head];
+        m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    T m_items[Capacity];
+    // 两个索引分开放在不同缓存行，避免生产者和消费者互相争用
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+#endif // LOCKFREEQUEUE_H
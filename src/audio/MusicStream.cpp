@@ -0,0 +1,291 @@
+#include "MusicStream.h"
+#include <QThread>
+#include <QFile>
+#include <QTimer>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+#include <QSysInfo>
+#include <QDebug>
+#include <cmath>
+
+const int MusicStream::RING_FRAMES;
+const int MusicStream::CHUNK_FRAMES;
+
+namespace {
+// 解码线程检查缓冲空间的间隔，远小于缓冲能播放的时长
+const int PUMP_INTERVAL_MS = 20;
+}
+
+MusicStream::Resampler::Resampler()
+    : m_sourceRate(0)
+    , m_step(1.0)
+    , m_position(0.0)
+{
+    std::fill(m_history, m_history + PcmCodec::CHANNELS, 0.0f);
+}
+
+void MusicStream::Resampler::reset(int sourceRate, int targetRate)
+{
+    m_sourceRate = sourceRate;
+    m_step = static_cast<double>(sourceRate) / targetRate;
+    m_position = 0.0;
+}
+
+void MusicStream::Resampler::process(const float* input, int frames, int channels, QVector<float>* output)
+{
+    if (frames <= 0 || channels <= 0) {
+        return;
+    }
+
+    // 位置-1表示上一块的最后一帧，这样插值可以跨过块边界
+    auto sampleAt = [&](int frame, int channel) {
+        return frame < 0 ? m_history[channel] : input[frame * channels + qMin(channel, channels - 1)];
+    };
+
+    while (m_position < frames - 1) {
+        const int index = static_cast<int>(std::floor(m_position));
+        const float fraction = static_cast<float>(m_position - index);
+        for (int channel = 0; channel < PcmCodec::CHANNELS; ++channel) {
+            const float a = sampleAt(index, channel);
+            const float b = sampleAt(index + 1, channel);
+            output->append(a + (b - a) * fraction);
+        }
+        m_position += m_step;
+    }
+    m_position -= frames;
+    for (int channel = 0; channel < PcmCodec::CHANNELS; ++channel) {
+        m_history[channel] = sampleAt(frames - 1, channel);
+    }
+}
+
+MusicStream::MusicStream(const QString& path, int sampleRate, bool loop)
+    : m_path(path)
+    , m_sampleRate(sampleRate)
+    , m_loop(loop)
+    , m_thread(nullptr)
+    , m_context(nullptr)
+    , m_pumpTimer(nullptr)
+    , m_ring(RING_FRAMES * PcmCodec::CHANNELS)
+    , m_endOfStream(false)
+    , m_file(nullptr)
+    , m_remainingBytes(0)
+    , m_decodedSinceRewind(false)
+    , m_decoder(nullptr)
+    , m_decoderFinished(false)
+    , m_pendingOffset(0)
+{
+}
+
+MusicStream::~MusicStream()
+{
+    if (!m_thread) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_context, [this]() { closeSource(); }, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_context;
+    delete m_thread;
+}
+
+bool MusicStream::start()
+{
+    m_thread = new QThread();
+    m_thread->setObjectName("MusicStream");
+    m_thread->start();
+
+    m_context = new QObject();
+    m_context->moveToThread(m_thread);
+
+    // 文件和解码器都在解码线程里打开，它们的信号也在这个线程处理
+    bool opened = false;
+    QMetaObject::invokeMethod(m_context, [this, &opened]() {
+        opened = openSource();
+        if (!opened) {
+            return;
+        }
+        pump();
+        m_pumpTimer = new QTimer(m_context);
+        m_pumpTimer->setInterval(PUMP_INTERVAL_MS);
+        QObject::connect(m_pumpTimer, &QTimer::timeout, m_context, [this]() { pump(); });
+        m_pumpTimer->start();
+    }, Qt::BlockingQueuedConnection);
+    return opened;
+}
+
+int MusicStream::read(float* output, int frames)
+{
+    return m_ring.read(output, frames * PcmCodec::CHANNELS) / PcmCodec::CHANNELS;
+}
+
+bool MusicStream::isFinished() const
+{
+    return m_endOfStream.load(std::memory_order_acquire) && m_ring.available() == 0;
+}
+
+bool MusicStream::openSource()
+{
+    m_file = new QFile(m_path);
+    if (m_file->open(QIODevice::ReadOnly) && PcmCodec::readWavHeader(m_file, &m_format)
+        && m_file->seek(m_format.dataOffset)) {
+        m_remainingBytes = m_format.dataBytes;
+        m_resampler.reset(m_format.sampleRate, m_sampleRate);
+        return true;
+    }
+    delete m_file;
+    m_file = nullptr;
+
+    // 请求与混音器一致的格式，后端不一定遵守，实际转换按每个缓冲自带的格式进行
+    QAudioFormat format;
+    format.setSampleRate(m_sampleRate);
+    format.setChannelCount(PcmCodec::CHANNELS);
+    format.setCodec("audio/pcm");
+    format.setByteOrder(QSysInfo::ByteOrder == QSysInfo::LittleEndian ? QAudioFormat::LittleEndian
+                                                                      : QAudioFormat::BigEndian);
+    format.setSampleType(QAudioFormat::Float);
+    format.setSampleSize(32);
+
+    m_decoder = new QAudioDecoder(m_context);
+    m_decoder->setAudioFormat(format);
+    m_decoder->setSourceFilename(m_path);
+    QObject::connect(m_decoder, &QAudioDecoder::bufferReady, m_context, [this]() { pump(); });
+    QObject::connect(m_decoder, &QAudioDecoder::finished, m_context, [this]() { onDecoderFinished(); });
+    QObject::connect(m_decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), m_context,
+                     [this](QAudioDecoder::Error error) {
+                         qDebug() << "Background music decode error:" << error << m_decoder->errorString();
+                         m_endOfStream = true;
+                     });
+    m_decoder->start();
+    return m_decoder->error() == QAudioDecoder::NoError;
+}
+
+void MusicStream::closeSource()
+{
+    delete m_pumpTimer;
+    m_pumpTimer = nullptr;
+    if (m_decoder) {
+        m_decoder->stop();
+        delete m_decoder;
+        m_decoder = nullptr;
+    }
+    delete m_file;
+    m_file = nullptr;
+}
+
+void MusicStream::pump()
+{
+    // 缓冲写满，或者解码器暂时没有数据时停下，等下一次定时器或解码器通知
+    while (flushPending() && !m_endOfStream.load(std::memory_order_relaxed)) {
+        const bool decoded = m_file ? decodeWavChunk() : decodeBufferedAudio();
+        if (!decoded) {
+            break;
+        }
+    }
+}
+
+bool MusicStream::flushPending()
+{
+    const int remaining = m_pending.size() - m_pendingOffset;
+    if (remaining > 0) {
+        m_pendingOffset += m_ring.write(m_pending.constData() + m_pendingOffset, remaining);
+        if (m_pendingOffset < m_pending.size()) {
+            return false;
+        }
+    }
+    // Qt 5.7起clear()保留容量，之后的块不再分配内存
+    m_pending.clear();
+    m_pendingOffset = 0;
+    return true;
+}
+
+bool MusicStream::decodeWavChunk()
+{
+    const int bytesPerFrame = m_format.bytesPerFrame();
+    if (m_remainingBytes < bytesPerFrame) {
+        // 到结尾时直接从数据区开头接着读，重采样状态也延续下去，循环处没有间隙
+        if (!m_loop || !m_decodedSinceRewind || !m_file->seek(m_format.dataOffset)) {
+            m_endOfStream = true;
+            return false;
+        }
+        m_remainingBytes = m_format.dataBytes;
+        m_decodedSinceRewind = false;
+    }
+
+    const qint64 bytes = qMin<qint64>(m_remainingBytes, CHUNK_FRAMES * bytesPerFrame) / bytesPerFrame * bytesPerFrame;
+    m_rawChunk.resize(static_cast<int>(bytes));
+    const qint64 bytesRead = m_file->read(m_rawChunk.data(), bytes);
+    const int frames = bytesRead > 0 ? static_cast<int>(bytesRead / bytesPerFrame) : 0;
+    // 文件比头里声明的短时把剩余部分当作结尾
+    m_remainingBytes = (bytesRead == bytes) ? m_remainingBytes - bytesRead : 0;
+    if (frames == 0) {
+        return true;
+    }
+    m_decodedSinceRewind = true;
+
+    const int samples = frames * m_format.channels;
+    m_decoded.resize(samples);
+    PcmCodec::toFloat(m_rawChunk.constData(), samples, m_format.encoding, m_format.bigEndian, m_decoded.data());
+    m_resampler.process(m_decoded.constData(), frames, m_format.channels, &m_pending);
+    return true;
+}
+
+bool MusicStream::decodeBufferedAudio()
+{
+    if (!m_decoder->bufferAvailable()) {
+        if (m_decoderFinished) {
+            // 已解码的数据全部取完才重新开始，缓冲里还有约一秒的音乐覆盖重启的时间
+            m_decoderFinished = false;
+            if (m_loop && m_decodedSinceRewind) {
+                m_decodedSinceRewind = false;
+                m_decoder->stop();
+                m_decoder->start();
+            } else {
+                m_endOfStream = true;
+            }
+        }
+        return false;
+    }
+
+    const QAudioBuffer buffer = m_decoder->read();
+    const QAudioFormat format = buffer.format();
+    const int channels = format.channelCount();
+    const int frames = buffer.frameCount();
+    if (!buffer.isValid() || channels <= 0 || frames <= 0) {
+        return true;
+    }
+
+    PcmCodec::SampleEncoding encoding;
+    if (format.sampleType() == QAudioFormat::Float && format.sampleSize() == 32) {
+        encoding = PcmCodec::Float32;
+    } else if (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 16) {
+        encoding = PcmCodec::Int16;
+    } else if (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 24) {
+        encoding = PcmCodec::Int24;
+    } else if (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 32) {
+        encoding = PcmCodec::Int32;
+    } else if (format.sampleType() == QAudioFormat::UnSignedInt && format.sampleSize() == 8) {
+        encoding = PcmCodec::UnsignedInt8;
+    } else if (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 8) {
+        encoding = PcmCodec::SignedInt8;
+    } else {
+        return true;
+    }
+
+    if (format.sampleRate() != m_resampler.sourceRate()) {
+        m_resampler.reset(format.sampleRate(), m_sampleRate);
+    }
+    m_decodedSinceRewind = true;
+
+    const int samples = frames * channels;
+    m_decoded.resize(samples);
+    PcmCodec::toFloat(static_cast<const char*>(buffer.constData()), samples, encoding,
+                      format.byteOrder() == QAudioFormat::BigEndian, m_decoded.data());
+    m_resampler.process(m_decoded.constData(), frames, channels, &m_pending);
+    return true;
+}
+
+void MusicStream::onDecoderFinished()
+{
+    m_decoderFinished = true;
+    pump();
+}
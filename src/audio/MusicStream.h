@@ -0,0 +1,96 @@
+#ifndef MUSICSTREAM_H
+#define MUSICSTREAM_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <atomic>
+#include "PcmCodec.h"
+#include "SampleRing.h"
+
+class QThread;
+class QObject;
+class QFile;
+class QTimer;
+class QAudioDecoder;
+class QAudioBuffer;
+
+// 背景音乐流
+// 在自己的线程里分块解码，转换成混音器采样率的立体声后写入固定大小的环形缓冲，
+// 混音线程从缓冲里取数据，内存占用与文件长度无关。
+// WAV由PcmCodec直接流式读取，其他格式交给QAudioDecoder，缓冲满时暂停取数据。
+// 循环播放时在缓冲耗尽之前就从头接着解码，首尾之间不插入静音。
+class MusicStream
+{
+public:
+    static const int RING_FRAMES = 65536;
+    static const int CHUNK_FRAMES = 4096;
+
+    MusicStream(const QString& path, int sampleRate, bool loop);
+    ~MusicStream();
+
+    // 打开文件并启动解码线程，成功返回时缓冲里已经有数据
+    bool start();
+
+    QString path() const { return m_path; }
+
+    // 以下两个函数只在混音线程调用：读出最多frames帧立体声，返回实际帧数
+    int read(float* output, int frames);
+    // 解码已经结束（非循环播放到结尾或出错）且缓冲已取空
+    bool isFinished() const;
+
+private:
+    // 跨块保持状态的线性插值重采样，块之间没有接缝
+    class Resampler
+    {
+    public:
+        Resampler();
+        void reset(int sourceRate, int targetRate);
+        int sourceRate() const { return m_sourceRate; }
+        void process(const float* input, int frames, int channels, QVector<float>* output);
+
+    private:
+        int m_sourceRate;
+        double m_step;
+        double m_position;
+        float m_history[PcmCodec::CHANNELS];
+    };
+
+    // 以下在解码线程执行
+    bool openSource();
+    void closeSource();
+    void pump();
+    bool flushPending();
+    bool decodeWavChunk();
+    bool decodeBufferedAudio();
+    void onDecoderFinished();
+
+    const QString m_path;
+    const int m_sampleRate;
+    const bool m_loop;
+
+    QThread* m_thread;
+    QObject* m_context;
+    QTimer* m_pumpTimer;
+
+    SampleRing m_ring;
+    std::atomic_bool m_endOfStream;
+
+    // WAV直接读取
+    QFile* m_file;
+    PcmCodec::StreamFormat m_format;
+    qint64 m_remainingBytes;
+    bool m_decodedSinceRewind;
+
+    // 其他格式
+    QAudioDecoder* m_decoder;
+    bool m_decoderFinished;
+
+    Resampler m_resampler;
+    QByteArray m_rawChunk;
+    QVector<float> m_decoded;
+    QVector<float> m_pending;
+    int m_pendingOffset;
+};
+
+#endif // MUSICSTREAM_H
@@ -0,0 +1,313 @@
+#include "PcmCodec.h"
+#include <QFile>
+#include <QBuffer>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+const int PcmCodec::CHANNELS;
+
+namespace {
+// 按SampleEncoding的顺序
+const int BYTES_PER_SAMPLE[] = { 1, 1, 2, 3, 4, 4 };
+}
+
+bool PcmCodec::decode(const QByteArray& data, int targetRate, PcmBuffer* out)
+{
+    if (data.size() < 12) {
+        return false;
+    }
+    if (data.startsWith("RIFF") && data.mid(8, 4) == "WAVE") {
+        return decodeWav(data, targetRate, out);
+    }
+    if (data.startsWith("FORM") && (data.mid(8, 4) == "AIFF" || data.mid(8, 4) == "AIFC")) {
+        return decodeAiff(data, targetRate, out);
+    }
+    return false;
+}
+
+bool PcmCodec::decodeFile(const QString& path, int targetRate, PcmBuffer* out)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return decode(file.readAll(), targetRate, out);
+}
+
+QByteArray PcmCodec::encodeWav(const QVector<float>& samples, int channels, int sampleRate)
+{
+    const quint32 dataBytes = static_cast<quint32>(samples.size()) * 2;
+    QByteArray wav(44 + static_cast<int>(dataBytes), Qt::Uninitialized);
+    uchar* p = reinterpret_cast<uchar*>(wav.data());
+
+    std::memcpy(p, "RIFF", 4);
+    qToLittleEndian<quint32>(36 + dataBytes, p + 4);
+    std::memcpy(p + 8, "WAVEfmt ", 8);
+    qToLittleEndian<quint32>(16, p + 16);
+    qToLittleEndian<quint16>(1, p + 20);
+    qToLittleEndian<quint16>(static_cast<quint16>(channels), p + 22);
+    qToLittleEndian<quint32>(static_cast<quint32>(sampleRate), p + 24);
+    qToLittleEndian<quint32>(static_cast<quint32>(sampleRate * channels * 2), p + 28);
+    qToLittleEndian<quint16>(static_cast<quint16>(channels * 2), p + 32);
+    qToLittleEndian<quint16>(16, p + 34);
+    std::memcpy(p + 36, "data", 4);
+    qToLittleEndian<quint32>(dataBytes, p + 40);
+
+    uchar* out = p + 44;
+    for (float sample : samples) {
+        const qint16 value = static_cast<qint16>(qRound(qBound(-1.0f, sample, 1.0f) * 32767.0f));
+        qToLittleEndian<qint16>(value, out);
+        out += 2;
+    }
+    return wav;
+}
+
+bool PcmCodec::decodeWav(const QByteArray& data, int targetRate, PcmBuffer* out)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    StreamFormat format;
+    if (!readWavHeader(&buffer, &format)) {
+        return false;
+    }
+    const qint64 bytes = qMin(format.dataBytes, data.size() - format.dataOffset);
+    return convert(data.constData() + format.dataOffset, bytes, format.channels, format.sampleRate,
+                   format.encoding, false, targetRate, out);
+}
+
+bool PcmCodec::readWavHeader(QIODevice* device, StreamFormat* format)
+{
+    const QByteArray header = device->read(12);
+    if (header.size() < 12 || !header.startsWith("RIFF") || header.mid(8, 4) != "WAVE") {
+        return false;
+    }
+
+    int formatTag = 0;
+    int bitsPerSample = 0;
+    format->channels = 0;
+    format->sampleRate = 0;
+    format->dataOffset = -1;
+
+    // 依次遍历RIFF子块，块长为奇数时有一个填充字节；遇到数据块就停止，不读取采样
+    qint64 offset = 12;
+    while (format->dataOffset < 0 && device->seek(offset)) {
+        const QByteArray chunk = device->read(8);
+        if (chunk.size() < 8) {
+            break;
+        }
+        const qint64 length = qFromLittleEndian<quint32>(chunk.constData() + 4);
+        const qint64 body = offset + 8;
+
+        if (chunk.startsWith("fmt ")) {
+            const QByteArray fmt = device->read(qMin<qint64>(length, 40));
+            const uchar* bytes = reinterpret_cast<const uchar*>(fmt.constData());
+            if (fmt.size() < 16) {
+                return false;
+            }
+            formatTag = qFromLittleEndian<quint16>(bytes);
+            format->channels = qFromLittleEndian<quint16>(bytes + 2);
+            format->sampleRate = static_cast<int>(qFromLittleEndian<quint32>(bytes + 4));
+            bitsPerSample = qFromLittleEndian<quint16>(bytes + 14);
+            // WAVE_FORMAT_EXTENSIBLE的实际格式在子格式GUID的前两个字节
+            if (formatTag == 0xFFFE && fmt.size() >= 26) {
+                formatTag = qFromLittleEndian<quint16>(bytes + 24);
+            }
+        } else if (chunk.startsWith("data")) {
+            format->dataOffset = body;
+            format->dataBytes = qMin(length, device->size() - body);
+        }
+        offset = body + length + (length & 1);
+    }
+
+    if (format->dataOffset < 0 || format->channels <= 0 || format->sampleRate <= 0) {
+        return false;
+    }
+
+    format->bigEndian = false;
+    if (formatTag == 3 && bitsPerSample == 32) {
+        format->encoding = Float32;
+    } else if (formatTag == 1 && bitsPerSample == 8) {
+        format->encoding = UnsignedInt8;
+    } else if (formatTag == 1 && bitsPerSample == 16) {
+        format->encoding = Int16;
+    } else if (formatTag == 1 && bitsPerSample == 24) {
+        format->encoding = Int24;
+    } else if (formatTag == 1 && bitsPerSample == 32) {
+        format->encoding = Int32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int PcmCodec::StreamFormat::bytesPerFrame() const
+{
+    return BYTES_PER_SAMPLE[encoding] * channels;
+}
+
+bool PcmCodec::decodeAiff(const QByteArray& data, int targetRate, PcmBuffer* out)
+{
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    const qint64 size = data.size();
+    const bool compressed = data.mid(8, 4) == "AIFC";
+
+    int channels = 0;
+    int bitsPerSample = 0;
+    double sampleRate = 0.0;
+    QByteArray compression("NONE");
+    const char* samples = nullptr;
+    qint64 sampleBytes = 0;
+
+    qint64 offset = 12;
+    while (offset + 8 <= size) {
+        const QByteArray id = data.mid(offset, 4);
+        const qint64 length = qFromBigEndian<quint32>(bytes + offset + 4);
+        const qint64 body = offset + 8;
+        const qint64 available = qMin(length, size - body);
+
+        if (id == "COMM" && available >= 18) {
+            channels = qFromBigEndian<quint16>(bytes + body);
+            bitsPerSample = qFromBigEndian<quint16>(bytes + body + 6);
+            sampleRate = readExtended(bytes + body + 8);
+            if (compressed && available >= 22) {
+                compression = data.mid(body + 18, 4);
+            }
+        } else if (id == "SSND" && available >= 8) {
+            const qint64 dataOffset = qFromBigEndian<quint32>(bytes + body);
+            samples = data.constData() + body + 8 + dataOffset;
+            sampleBytes = qMax<qint64>(0, available - 8 - dataOffset);
+        }
+        offset = body + length + (length & 1);
+    }
+
+    if (!samples || channels <= 0 || sampleRate <= 0.0) {
+        return false;
+    }
+
+    bool bigEndian = true;
+    SampleEncoding encoding;
+    if (compression == "fl32" || compression == "FL32") {
+        encoding = Float32;
+    } else if (compression == "NONE" || compression == "sowt") {
+        bigEndian = (compression == "NONE");
+        switch (bitsPerSample) {
+            case 8: encoding = SignedInt8; break;
+            case 16: encoding = Int16; break;
+            case 24: encoding = Int24; break;
+            case 32: encoding = Int32; break;
+            default: return false;
+        }
+    } else {
+        return false;
+    }
+    return convert(samples, sampleBytes, channels, qRound(sampleRate), encoding, bigEndian, targetRate, out);
+}
+
+bool PcmCodec::convert(const char* data, qint64 bytes, int channels, int sourceRate,
+                       SampleEncoding encoding, bool bigEndian, int targetRate, PcmBuffer* out)
+{
+    StreamFormat format;
+    format.channels = channels;
+    format.encoding = encoding;
+    const int frames = static_cast<int>(bytes / format.bytesPerFrame());
+    if (frames <= 0) {
+        return false;
+    }
+
+    QVector<float> interleaved(frames * channels);
+    toFloat(data, frames * channels, encoding, bigEndian, interleaved.data());
+
+    out->sampleRate = targetRate;
+    out->samples.clear();
+    appendConverted(interleaved.constData(), frames, channels, sourceRate, targetRate, &out->samples);
+    out->frames = out->samples.size() / CHANNELS;
+    return out->frames > 0;
+}
+
+void PcmCodec::toFloat(const char* data, int sampleCount, SampleEncoding encoding, bool bigEndian, float* out)
+{
+    const int sampleSize = BYTES_PER_SAMPLE[encoding];
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    for (int i = 0; i < sampleCount; ++i, p += sampleSize) {
+        float value = 0.0f;
+        switch (encoding) {
+            case UnsignedInt8:
+                value = (static_cast<int>(p[0]) - 128) / 128.0f;
+                break;
+            case SignedInt8:
+                value = static_cast<qint8>(p[0]) / 128.0f;
+                break;
+            case Int16:
+                value = (bigEndian ? qFromBigEndian<qint16>(p) : qFromLittleEndian<qint16>(p)) / 32768.0f;
+                break;
+            case Int24: {
+                const quint32 raw = bigEndian ? (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8)
+                                              : (quint32(p[2]) << 24) | (quint32(p[1]) << 16) | (quint32(p[0]) << 8);
+                value = static_cast<qint32>(raw) / 2147483648.0f;
+                break;
+            }
+            case Int32:
+                value = (bigEndian ? qFromBigEndian<qint32>(p) : qFromLittleEndian<qint32>(p)) / 2147483648.0f;
+                break;
+            case Float32: {
+                const quint32 raw = bigEndian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+                std::memcpy(&value, &raw, sizeof(value));
+                break;
+            }
+        }
+        out[i] = value;
+    }
+}
+
+void PcmCodec::appendConverted(const float* interleaved, int frames, int channels,
+                               int sourceRate, int targetRate, QVector<float>* out)
+{
+    if (frames <= 0 || channels <= 0 || sourceRate <= 0 || targetRate <= 0) {
+        return;
+    }
+
+    // 单声道复制到两个声道，多于两个声道时只取前两个
+    auto sampleAt = [&](int frame, int channel) {
+        return interleaved[frame * channels + qMin(channel, channels - 1)];
+    };
+
+    if (sourceRate == targetRate) {
+        out->reserve(out->size() + frames * CHANNELS);
+        for (int frame = 0; frame < frames; ++frame) {
+            out->append(sampleAt(frame, 0));
+            out->append(sampleAt(frame, 1));
+        }
+        return;
+    }
+
+    // 音效和音乐都不需要高质量重采样，线性插值足够
+    const double step = static_cast<double>(sourceRate) / targetRate;
+    const int outputFrames = static_cast<int>(std::floor((frames - 1) / step)) + 1;
+    out->reserve(out->size() + outputFrames * CHANNELS);
+    for (int i = 0; i < outputFrames; ++i) {
+        const double position = i * step;
+        const int index = static_cast<int>(position);
+        const int next = qMin(index + 1, frames - 1);
+        const float fraction = static_cast<float>(position - index);
+        for (int channel = 0; channel < CHANNELS; ++channel) {
+            const float a = sampleAt(index, channel);
+            const float b = sampleAt(next, channel);
+            out->append(a + (b - a) * fraction);
+        }
+    }
+}
+
+double PcmCodec::readExtended(const uchar* bytes)
+{
+    // 80位IEEE扩展精度：1位符号、15位指数、64位显式尾数
+    const int exponent = ((bytes[0] & 0x7F) << 8) | bytes[1];
+    const quint64 mantissa = qFromBigEndian<quint64>(bytes + 2);
+    if (exponent == 0 && mantissa == 0) {
+        return 0.0;
+    }
+    const double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    return (bytes[0] & 0x80) ? -value : value;
+}
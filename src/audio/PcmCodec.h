@@ -0,0 +1,67 @@
+#ifndef PCMCODEC_H
+#define PCMCODEC_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class QIODevice;
+
+// 解码后的PCM数据：交错的立体声浮点采样，已经换算到混音器的采样率
+struct PcmBuffer {
+    int sampleRate;
+    int frames;
+    QVector<float> samples;
+
+    PcmBuffer() : sampleRate(0), frames(0) {}
+    bool isEmpty() const { return frames == 0; }
+};
+
+// 未压缩音频的编解码
+// 支持WAV（整数PCM和32位浮点）以及AIFF/AIFF-C（NONE、sowt、fl32），
+// 足以覆盖系统提示音和自带音效；压缩格式交给QAudioDecoder。
+class PcmCodec
+{
+public:
+    static const int CHANNELS = 2;
+
+    enum SampleEncoding { UnsignedInt8, SignedInt8, Int16, Int24, Int32, Float32 };
+
+    // WAV数据区的格式和位置，流式读取时用
+    struct StreamFormat {
+        int channels;
+        int sampleRate;
+        SampleEncoding encoding;
+        bool bigEndian;
+        qint64 dataOffset;
+        qint64 dataBytes;
+
+        int bytesPerFrame() const;
+    };
+
+    // 按文件头识别格式，解码并重采样到targetRate
+    static bool decode(const QByteArray& data, int targetRate, PcmBuffer* out);
+    static bool decodeFile(const QString& path, int targetRate, PcmBuffer* out);
+
+    // 把交错浮点采样编码成16位整数PCM的WAV
+    static QByteArray encodeWav(const QVector<float>& samples, int channels, int sampleRate);
+
+    // 把任意声道数的交错浮点采样转成立体声并做线性插值重采样，流式解码也会用到
+    static void appendConverted(const float* interleaved, int frames, int channels,
+                                int sourceRate, int targetRate, QVector<float>* out);
+
+    // 只解析WAV头，不读取数据区；成功后设备位置不确定，调用方需要自己seek
+    static bool readWavHeader(QIODevice* device, StreamFormat* format);
+
+    // 把sampleCount个原始采样转换成[-1, 1]的浮点数
+    static void toFloat(const char* data, int sampleCount, SampleEncoding encoding, bool bigEndian, float* out);
+
+private:
+    static bool decodeWav(const QByteArray& data, int targetRate, PcmBuffer* out);
+    static bool decodeAiff(const QByteArray& data, int targetRate, PcmBuffer* out);
+    static bool convert(const char* data, qint64 bytes, int channels, int sourceRate,
+                        SampleEncoding encoding, bool bigEndian, int targetRate, PcmBuffer* out);
+    static double readExtended(const uchar* bytes);
+};
+
+#endif // PCMCODEC_H
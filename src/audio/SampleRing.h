@@ -0,0 +1,79 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// 单生产者单消费者的浮点采样环形缓冲
+// 容量固定（必须是2的幂），读写索引单调递增，两端都不加锁也不分配内存。
+class SampleRing
+{
+public:
+    explicit SampleRing(int capacity)
+        : m_buffer(new float[capacity])
+        , m_capacity(capacity)
+        , m_readIndex(0)
+        , m_writeIndex(0)
+    {
+    }
+
+    int capacity() const { return m_capacity; }
+
+    int available() const
+    {
+        return static_cast<int>(m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire));
+    }
+
+    int freeSpace() const { return m_capacity - available(); }
+
+    // 只能由生产者线程调用，返回实际写入的采样数
+    int write(const float* data, int count)
+    {
+        const quint64 writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        const quint64 readIndex = m_readIndex.load(std::memory_order_acquire);
+        const int written = std::min(count, m_capacity - static_cast<int>(writeIndex - readIndex));
+        copyIn(data, written, writeIndex);
+        m_writeIndex.store(writeIndex + written, std::memory_order_release);
+        return written;
+    }
+
+    // 只能由消费者线程调用，返回实际读出的采样数
+    int read(float* data, int count)
+    {
+        const quint64 readIndex = m_readIndex.load(std::memory_order_relaxed);
+        const quint64 writeIndex = m_writeIndex.load(std::memory_order_acquire);
+        const int taken = std::min(count, static_cast<int>(writeIndex - readIndex));
+        copyOut(data, taken, readIndex);
+        m_readIndex.store(readIndex + taken, std::memory_order_release);
+        return taken;
+    }
+
+private:
+    // 环绕处分两段拷贝
+    void copyIn(const float* data, int count, quint64 index)
+    {
+        const int start = static_cast<int>(index & static_cast<quint64>(m_capacity - 1));
+        const int first = std::min(count, m_capacity - start);
+        std::memcpy(m_buffer.get() + start, data, first * sizeof(float));
+        std::memcpy(m_buffer.get(), data + first, (count - first) * sizeof(float));
+    }
+
+    void copyOut(float* data, int count, quint64 index) const
+    {
+        const int start = static_cast<int>(index & static_cast<quint64>(m_capacity - 1));
+        const int first = std::min(count, m_capacity - start);
+        std::memcpy(data, m_buffer.get() + start, first * sizeof(float));
+        std::memcpy(data + first, m_buffer.get(), (count - first) * sizeof(float));
+    }
+
+    std::unique_ptr<float[]> m_buffer;
+    const int m_capacity;
+    // 两个索引分开放在不同缓存行，避免生产者和消费者互相争用
+    alignas(64) std::atomic<quint64> m_readIndex;
+    alignas(64) std::atomic<quint64> m_writeIndex;
+};
+
+#endif // SAMPLERING_H
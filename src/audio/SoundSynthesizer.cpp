@@ -0,0 +1,133 @@
+#include "SoundSynthesizer.h"
+#include "PcmCodec.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cmath>
+
+namespace {
+// 合成算法有变化时递增，使旧缓存失效
+const int SYNTH_VERSION = 1;
+const float TWO_PI = 6.28318530718f;
+}
+
+QByteArray SoundSynthesizer::renderWav(const Patch& patch, int sampleRate)
+{
+    return PcmCodec::encodeWav(render(patch, sampleRate), 1, sampleRate);
+}
+
+QByteArray SoundSynthesizer::cachedWav(const Patch& patch, int sampleRate)
+{
+    const QString directory = cacheDirectory();
+    const QString path = directory + "/" + cacheKey(patch, sampleRate) + ".wav";
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        const QByteArray cached = file.readAll();
+        if (cached.size() > 44 && cached.startsWith("RIFF")) {
+            return cached;
+        }
+    }
+
+    const QByteArray wav = renderWav(patch, sampleRate);
+
+    // 写缓存失败不影响本次使用
+    QDir().mkpath(directory);
+    QSaveFile output(path);
+    if (output.open(QIODevice::WriteOnly)) {
+        output.write(wav);
+        output.commit();
+    }
+    return wav;
+}
+
+QString SoundSynthesizer::cacheKey(const Patch& patch, int sampleRate)
+{
+    QByteArray parameters;
+    QDataStream stream(&parameters, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << SYNTH_VERSION << sampleRate << patch.gain << patch.tones.size();
+    for (const Tone& tone : patch.tones) {
+        stream << tone.startMs << tone.durationMs << tone.frequency << tone.endFrequency
+               << static_cast<int>(tone.waveform) << tone.attackMs << tone.decayMs
+               << tone.noise << tone.gain;
+    }
+    return QString::fromLatin1(QCryptographicHash::hash(parameters, QCryptographicHash::Sha1).toHex().left(16));
+}
+
+QVector<float> SoundSynthesizer::render(const Patch& patch, int sampleRate)
+{
+    float lengthMs = 0.0f;
+    for (const Tone& tone : patch.tones) {
+        lengthMs = qMax(lengthMs, tone.startMs + tone.durationMs);
+    }
+    const int frames = static_cast<int>(std::ceil(lengthMs * sampleRate / 1000.0f));
+    QVector<float> output(frames, 0.0f);
+
+    // 固定种子的线性同余噪声，保证同样的参数总是得到同样的结果
+    quint32 seed = 0x2545F491u;
+    auto nextNoise = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+    };
+
+    for (const Tone& tone : patch.tones) {
+        const int start = qRound(tone.startMs * sampleRate / 1000.0f);
+        const int count = qMin(qRound(tone.durationMs * sampleRate / 1000.0f), frames - start);
+        if (count <= 0) {
+            continue;
+        }
+        const float attack = qMax(1.0f, tone.attackMs * sampleRate / 1000.0f);
+        const float decay = tone.decayMs * sampleRate / 1000.0f;
+        // 音符末尾淡出，避免截断处的爆音
+        const float fade = qMax(1.0f, qMin(count / 4.0f, sampleRate * 0.005f));
+
+        float phase = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            const float progress = static_cast<float>(i) / count;
+            const float frequency = tone.frequency + (tone.endFrequency - tone.frequency) * progress;
+            phase += frequency / sampleRate;
+            phase -= std::floor(phase);
+
+            float oscillator = 0.0f;
+            switch (tone.waveform) {
+                case Sine:
+                    oscillator = std::sin(TWO_PI * phase);
+                    break;
+                case Triangle:
+                    oscillator = 4.0f * std::fabs(phase - 0.5f) - 1.0f;
+                    break;
+                case Square:
+                    // 软削波的方波，听感接近方波但高次谐波少，不容易刺耳
+                    oscillator = std::tanh(3.0f * std::sin(TWO_PI * phase));
+                    break;
+            }
+            const float value = oscillator * (1.0f - tone.noise) + nextNoise() * tone.noise;
+
+            float envelope = (i < attack) ? i / attack
+                           : (decay > 0.0f ? std::exp(-(i - attack) / decay) : 1.0f);
+            if (count - i < fade) {
+                envelope *= (count - i) / fade;
+            }
+            output[start + i] += value * envelope * tone.gain;
+        }
+    }
+
+    float peak = 0.0f;
+    for (float sample : output) {
+        peak = qMax(peak, std::fabs(sample));
+    }
+    const float scale = patch.gain / qMax(1.0f, peak);
+    for (float& sample : output) {
+        sample *= scale;
+    }
+    return output;
+}
+
+QString SoundSynthesizer::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/sounds";
+}
@@ -0,0 +1,53 @@
+#ifndef SOUNDSYNTHESIZER_H
+#define SOUNDSYNTHESIZER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// 程序化音效合成
+// 一个音色由若干音符叠加而成，每个音符有自己的波形、滑音、包络和噪声比例。
+// 合成结果是内存中的WAV，并按参数哈希缓存到磁盘，下次启动直接读取。
+class SoundSynthesizer
+{
+public:
+    enum Waveform {
+        Sine = 0,
+        Triangle = 1,
+        Square = 2
+    };
+
+    struct Tone {
+        float startMs;
+        float durationMs;
+        float frequency;
+        float endFrequency;     // 在持续时间内线性滑到这个频率
+        Waveform waveform;
+        float attackMs;
+        float decayMs;          // 起音之后的指数衰减时间常数
+        float noise;            // 0到1，白噪声所占比例
+        float gain;
+    };
+
+    struct Patch {
+        QVector<Tone> tones;
+        float gain;
+
+        Patch() : gain(0.8f) {}
+    };
+
+    // 合成单声道WAV
+    static QByteArray renderWav(const Patch& patch, int sampleRate);
+
+    // 先查磁盘缓存，未命中时合成并写回缓存；可在任意线程调用
+    static QByteArray cachedWav(const Patch& patch, int sampleRate);
+
+    // 由全部参数和采样率决定的缓存键
+    static QString cacheKey(const Patch& patch, int sampleRate);
+
+private:
+    static QVector<float> render(const Patch& patch, int sampleRate);
+    static QString cacheDirectory();
+};
+
+#endif // SOUNDSYNTHESIZER_H
@@ -14,6 +14,9 @@ bool ChessBoard::placePiece(const QPoint& position, PieceType type)
     }
     
     m_board[position.y()][position.x()] = type;
+    updateLiveWindows(MoveIndex::fromPoint(position), type, true);
+    ++m_stoneCounts[type];
+    --m_stoneCounts[Empty];
     pushMove(position);
     
     emit pieceAdded(position, type);
@@ -26,7 +29,11 @@ bool ChessBoard::removePiece(const QPoint& position)
         return false;
     }
     
+    const PieceType type = m_board[position.y()][position.x()];
+    --m_stoneCounts[type];
+    ++m_stoneCounts[Empty];
     m_board[position.y()][position.x()] = Empty;
+    updateLiveWindows(MoveIndex::fromPoint(position), type, false);
     emit pieceRemoved(position);
     return true;
 }
@@ -39,6 +46,13 @@ void ChessBoard::clearBoard()
         }
     }
     m_moveHistory.clear();
+    m_lines.clear();
+    m_stoneCounts[Empty] = BOARD_SIZE * BOARD_SIZE;
+    m_stoneCounts[Black] = 0;
+    m_stoneCounts[White] = 0;
+    m_liveWindows[Empty] = 0;
+    m_liveWindows[Black] = m_lines.liveWindows(Black);
+    m_liveWindows[White] = m_lines.liveWindows(White);
     emit boardCleared();
 }
 
@@ -65,26 +79,19 @@ bool ChessBoard::isValidPosition(const QPoint& position) const
     return isInBounds(position.y(), position.x());
 }
 
-bool ChessBoard::isFull() const
-{
-    for (int row = 0; row < BOARD_SIZE; ++row) {
-        for (int col = 0; col < BOARD_SIZE; ++col) {
-            if (m_board[row][col] == Empty) {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
 QList<QPoint> ChessBoard::moveHistory() const
 {
-    return m_moveHistory;
+    QList<QPoint> history;
+    history.reserve(m_moveHistory.size());
+    for (MoveIndex move : m_moveHistory) {
+        history.append(move.toPoint());
+    }
+    return history;
 }
 
 QPoint ChessBoard::lastMove() const
 {
-    return hasHistory() ? m_moveHistory.last() : QPoint(-1, -1);
+    return lastMoveIndex().toPoint();
 }
 
 bool ChessBoard::hasHistory() const
@@ -94,7 +101,7 @@ bool ChessBoard::hasHistory() const
 
 void ChessBoard::pushMove(const QPoint& position)
 {
-    m_moveHistory.append(position);
+    m_moveHistory.append(MoveIndex::fromPoint(position));
 }
 
 QPoint ChessBoard::popMove()
@@ -103,7 +110,7 @@ QPoint ChessBoard::popMove()
         return QPoint(-1, -1);
     }
     
-    QPoint lastPosition = m_moveHistory.takeLast();
+    QPoint lastPosition = m_moveHistory.takeLast().toPoint();
     removePiece(lastPosition);
     return lastPosition;
 }
@@ -119,11 +126,16 @@ void ChessBoard::getBoardState(PieceType board[BOARD_SIZE][BOARD_SIZE]) const
 
 void ChessBoard::setBoardState(const PieceType board[BOARD_SIZE][BOARD_SIZE])
 {
+    m_lines.clear();
     for (int row = 0; row < BOARD_SIZE; ++row) {
         for (int col = 0; col < BOARD_SIZE; ++col) {
             m_board[row][col] = board[row][col];
+            if (board[row][col] != Empty) {
+                m_lines.place(MoveIndex::fromRowCol(row, col), board[row][col]);
+            }
         }
     }
+    recountStones();
 }
 
 QByteArray ChessBoard::serialize() const
@@ -138,10 +150,10 @@ QByteArray ChessBoard::serialize() const
         }
     }
     
-    // 序列化移动历史
+    // 序列化移动历史（保持QPoint格式以兼容旧数据）
     stream << m_moveHistory.size();
-    for (const QPoint& move : m_moveHistory) {
-        stream << move;
+    for (MoveIndex move : m_moveHistory) {
+        stream << move.toPoint();
     }
     
     return data;
@@ -153,11 +165,19 @@ bool ChessBoard::deserialize(const QByteArray& data)
     
     try {
         // 反序列化棋盘状态
+        m_lines.clear();
         for (int row = 0; row < BOARD_SIZE; ++row) {
             for (int col = 0; col < BOARD_SIZE; ++col) {
                 int pieceValue;
                 stream >> pieceValue;
+                // 损坏的数据按空位处理，保证计数数组不越界
+                if (pieceValue < Empty || pieceValue > White) {
+                    pieceValue = Empty;
+                }
                 m_board[row][col] = static_cast<PieceType>(pieceValue);
+                if (m_board[row][col] != Empty) {
+                    m_lines.place(MoveIndex::fromRowCol(row, col), m_board[row][col]);
+                }
             }
         }
         
@@ -170,15 +190,42 @@ bool ChessBoard::deserialize(const QByteArray& data)
         for (int i = 0; i < historySize; ++i) {
             QPoint move;
             stream >> move;
-            m_moveHistory.append(move);
+            m_moveHistory.append(MoveIndex::fromPoint(move));
         }
         
+        recountStones();
         return true;
     } catch (...) {
         return false;
     }
 }
 
+void ChessBoard::recountStones()
+{
+    m_stoneCounts[Empty] = m_stoneCounts[Black] = m_stoneCounts[White] = 0;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            ++m_stoneCounts[m_board[row][col]];
+        }
+    }
+    m_liveWindows[Empty] = 0;
+    m_liveWindows[Black] = m_lines.liveWindows(Black);
+    m_liveWindows[White] = m_lines.liveWindows(White);
+}
+
+void ChessBoard::updateLiveWindows(MoveIndex move, PieceType type, bool placing)
+{
+    // 一颗棋子只影响对方的活窗口，而且只在经过它的四条线上；落子前后各数一次取差
+    const PieceType opponent = (type == Black) ? White : Black;
+    const int before = m_lines.liveWindowsThrough(move, opponent);
+    if (placing) {
+        m_lines.place(move, type);
+    } else {
+        m_lines.remove(move);
+    }
+    m_liveWindows[opponent] += m_lines.liveWindowsThrough(move, opponent) - before;
+}
+
 bool ChessBoard::isInBounds(int row, int col) const
 {
     return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
@@ -4,7 +4,10 @@
 #include <QObject>
 #include <QPoint>
 #include <QList>
+#include <QVector>
 #include <QByteArray>
+#include "MoveIndex.h"
+#include "LineBoard.h"
 
 class ChessBoard : public QObject
 {
@@ -14,6 +17,27 @@ public:
     enum PieceType { Empty = 0, Black = 1, White = 2 };
     static const int BOARD_SIZE = 15;
     
+    // 落子历史的只读视图，直接指向内部存储，不复制也不触发隐式共享的分离；
+    // 棋盘下一次被修改后失效，不要跨修改保存
+    class HistoryView
+    {
+    public:
+        typedef const MoveIndex* const_iterator;
+        
+        HistoryView(const MoveIndex* data, int size) : m_data(data), m_size(size) {}
+        
+        int size() const { return m_size; }
+        bool isEmpty() const { return m_size == 0; }
+        MoveIndex operator[](int ply) const { return m_data[ply]; }
+        MoveIndex last() const { return m_size > 0 ? m_data[m_size - 1] : MoveIndex(); }
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+        
+    private:
+        const MoveIndex* m_data;
+        int m_size;
+    };
+    
     explicit ChessBoard(QObject *parent = nullptr);
     
     // 棋盘操作
@@ -26,12 +50,24 @@ public:
     PieceType pieceAt(int row, int col) const;
     bool isEmpty(const QPoint& position) const;
     bool isValidPosition(const QPoint& position) const;
-    bool isFull() const;
+    bool isFull() const { return m_stoneCounts[Empty] == 0; }
+    const LineBoard& lines() const { return m_lines; }
+    
+    // 某方仍可能连成五的五格窗口数（窗口内没有对方棋子），随落子和提子增量维护
+    int liveWindows(PieceType type) const { return m_liveWindows[type]; }
+    // 双方都已不可能连成五，棋局注定和棋
+    bool isDeadPosition() const { return m_liveWindows[Black] == 0 && m_liveWindows[White] == 0; }
     
     // 历史管理
-    QList<QPoint> moveHistory() const;
+    QList<QPoint> moveHistory() const;      // 复制一份QPoint列表，只在需要QPoint容器时使用
+    HistoryView history() const { return HistoryView(m_moveHistory.constData(), m_moveHistory.size()); }
+    int moveCount() const { return m_moveHistory.size(); }
+    MoveIndex lastMoveIndex() const { return m_moveHistory.isEmpty() ? MoveIndex() : m_moveHistory.last(); }
     QPoint lastMove() const;
     bool hasHistory() const;
+    
+    // 各方棋子数，随落子和提子增量维护
+    int stoneCount(PieceType type) const { return m_stoneCounts[type]; }
     void pushMove(const QPoint& position);
     QPoint popMove();
     
@@ -49,8 +85,14 @@ signals:
 private:
     bool isInBounds(int row, int col) const;
     
+    void recountStones();
+    void updateLiveWindows(MoveIndex move, PieceType type, bool placing);
+    
     PieceType m_board[BOARD_SIZE][BOARD_SIZE];
-    QList<QPoint> m_moveHistory;
+    int m_stoneCounts[3];               // 按PieceType下标，Empty一项为空位数
+    int m_liveWindows[3];               // 按PieceType下标，Empty一项不用
+    QVector<MoveIndex> m_moveHistory;   // 每步1字节的紧凑历史
+    LineBoard m_lines;                  // 与m_board同步的按线位棋盘，用于快速判胜和棋型扫描
 };
 
 #endif // CHESSBOARD_H 
\ No newline at end of file
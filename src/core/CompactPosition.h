@@ -0,0 +1,54 @@
+#ifndef COMPACTPOSITION_H
+#define COMPACTPOSITION_H
+
+#include <QtGlobal>
+#include <cstring>
+#include "ChessBoard.h"
+#include "MoveIndex.h"
+
+// 紧凑局面：每格2位（0=空 1=黑 2=白），225格共57字节，加上行棋方补齐到64字节。
+// 平凡可复制，可以整块存放在连续数组/文件中，批量处理时不需要构造ChessBoard。
+struct CompactPosition
+{
+    static const int PACKED_BYTES = (MoveIndex::CELL_COUNT + 3) / 4;
+
+    quint8 cells[PACKED_BYTES];
+    quint8 sideToMove;            // ChessBoard::PieceType，0表示按双方子数推断
+    quint8 reserved[64 - PACKED_BYTES - 1];
+
+    void clear() { std::memset(this, 0, sizeof(CompactPosition)); }
+
+    ChessBoard::PieceType pieceAt(MoveIndex move) const
+    {
+        const int index = move.value();
+        return static_cast<ChessBoard::PieceType>((cells[index >> 2] >> ((index & 3) * 2)) & 0x3);
+    }
+
+    void setPiece(MoveIndex move, ChessBoard::PieceType type)
+    {
+        const int index = move.value();
+        const int shift = (index & 3) * 2;
+        cells[index >> 2] = static_cast<quint8>((cells[index >> 2] & ~(0x3 << shift)) | (type << shift));
+    }
+
+    static CompactPosition fromBoard(const ChessBoard* board, ChessBoard::PieceType toMove = ChessBoard::Empty)
+    {
+        CompactPosition position;
+        position.clear();
+        for (int row = 0; row < ChessBoard::BOARD_SIZE; ++row) {
+            for (int col = 0; col < ChessBoard::BOARD_SIZE; ++col) {
+                ChessBoard::PieceType piece = board->pieceAt(row, col);
+                if (piece != ChessBoard::Empty) {
+                    position.setPiece(MoveIndex::fromRowCol(row, col), piece);
+                }
+            }
+        }
+        position.sideToMove = static_cast<quint8>(toMove);
+        return position;
+    }
+};
+
+Q_DECLARE_TYPEINFO(CompactPosition, Q_PRIMITIVE_TYPE);
+static_assert(sizeof(CompactPosition) == 64, "CompactPosition must stay one cache line");
+
+#endif // COMPACTPOSITION_H
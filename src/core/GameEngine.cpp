@@ -31,12 +31,9 @@ void GameEngine::startNewGame(GameMode mode)
     
     m_mode = mode;
     m_state = Playing;
-    m_currentPlayerIndex = 0; // 黑方先手
-    m_winner = ChessBoard::Empty;
-    m_undoCount = 0;
     
-    // 清空棋盘
-    m_board->clearBoard();
+    // 黑方先手，清空棋盘和棋谱
+    initializeGame();
     
     // 重新设置玩家
     setupPlayers();
@@ -96,6 +93,28 @@ void GameEngine::restartGame()
     startNewGame(m_mode);
 }
 
+bool GameEngine::restoreGame(GameMode mode, const QVector<MoveIndex>& moves)
+{
+    bool decided = false;
+    if (!validateMoves(moves, &decided) || decided) {
+        return false;
+    }
+    
+    replayGame(mode, moves);
+    return true;
+}
+
+bool GameEngine::loadGame(GameMode mode, const QVector<MoveIndex>& moves)
+{
+    bool decided = false;
+    if (!validateMoves(moves, &decided)) {
+        return false;
+    }
+    
+    replayGame(mode, moves);
+    return true;
+}
+
 bool GameEngine::makeMove(const QPoint& position)
 {
     if (m_state != Playing) {
@@ -116,6 +135,7 @@ bool GameEngine::makeMove(const QPoint& position)
         emit errorOccurred("无法放置棋子");
         return false;
     }
+    m_record.play(MoveIndex::fromPoint(position));
     
     emit moveMade(position, currentPiece);
     
@@ -139,37 +159,60 @@ bool GameEngine::undoMove()
         return false;
     }
     
-    QPoint lastMove = m_board->popMove();
-    if (lastMove.x() >= 0 && lastMove.y() >= 0) {
-        m_undoCount++;
-        
-        // 切换回上一个玩家
-        m_currentPlayerIndex = (m_currentPlayerIndex + 1) % 2;
-        
-        emit moveUndone(lastMove);
-        emit playerChanged(currentPlayer());
-        
-        // 如果是人机对战，可能需要悔棋两步
-        if (m_mode == PvC && m_board->hasHistory()) {
-            // 悔棋AI的一步
-            QPoint aiMove = m_board->popMove();
-            if (aiMove.x() >= 0 && aiMove.y() >= 0) {
-                emit moveUndone(aiMove);
-            }
-        }
-        
-        // 重新请求当前玩家下棋
-        requestPlayerMove();
-        
-        return true;
+    // 人机对战退回到人类玩家的回合，AI的一手随之撤销
+    int target = m_record.node(m_record.cursor()).parent;
+    if (isAITurnAt(target) && target != GameRecord::ROOT) {
+        target = m_record.node(target).parent;
+    }
+    
+    m_undoCount++;
+    replayTo(target);
+    return true;
+}
+
+bool GameEngine::redoMove()
+{
+    if (!canRedo()) {
+        return false;
     }
     
-    return false;
+    int target = m_record.node(m_record.cursor()).activeChild;
+    if (isAITurnAt(target) && m_record.node(target).activeChild >= 0) {
+        target = m_record.node(target).activeChild;
+    }
+    
+    replayTo(target);
+    return true;
 }
 
 bool GameEngine::canUndo() const
 {
-    return m_state == Playing && m_board->hasHistory();
+    return canNavigate() && m_record.canUndo();
+}
+
+bool GameEngine::canRedo() const
+{
+    return canNavigate() && m_record.canRedo();
+}
+
+bool GameEngine::jumpToPly(int ply)
+{
+    if (!canNavigate()) {
+        return false;
+    }
+    return jumpToNode(m_record.nodeAtPly(ply));
+}
+
+bool GameEngine::jumpToNode(int node)
+{
+    if (!canNavigate() || !m_record.isValidNode(node)) {
+        return false;
+    }
+    
+    if (node != m_record.cursor()) {
+        replayTo(node);
+    }
+    return true;
 }
 
 ChessBoard::PieceType GameEngine::currentPlayer() const
@@ -179,7 +222,7 @@ ChessBoard::PieceType GameEngine::currentPlayer() const
 
 int GameEngine::moveCount() const
 {
-    return m_board->moveHistory().size();
+    return m_board->moveCount();
 }
 
 qint64 GameEngine::elapsedTime() const
@@ -243,8 +286,10 @@ void GameEngine::initializeGame()
 {
     m_currentPlayerIndex = 0;
     m_winner = ChessBoard::Empty;
+    m_winLine = GameRule::WinLine();
     m_undoCount = 0;
     m_board->clearBoard();
+    m_record.clear();
 }
 
 void GameEngine::setupPlayers()
@@ -301,10 +346,12 @@ void GameEngine::checkGameEnd()
     QPoint lastMove = m_board->lastMove();
     if (lastMove.x() >= 0 && lastMove.y() >= 0) {
         // 检查是否有玩家获胜
-        if (m_rule->checkWin(lastMove, m_board)) {
-            m_winner = m_board->pieceAt(lastMove);
+        GameRule::WinInfo winInfo;
+        if (m_rule->checkWin(lastMove, m_board, &winInfo)) {
+            m_winner = winInfo.winner;
+            m_winLine = winInfo.line;
             m_state = Finished;
-            emit gameWon(m_winner);
+            emit gameWon(m_winner, winInfo.line);
             emit gameStateChanged(m_state);
             return;
         }
@@ -318,6 +365,103 @@ void GameEngine::checkGameEnd()
     }
 }
 
+bool GameEngine::validateMoves(const QVector<MoveIndex>& moves, bool* decided) const
+{
+    // 在临时棋盘上走一遍：每一手都合法，分出胜负之后不能再有着法
+    ChessBoard scratch;
+    *decided = false;
+    for (int i = 0; i < moves.size(); ++i) {
+        const QPoint position = moves[i].toPoint();
+        const ChessBoard::PieceType piece = (i % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+        if (*decided || !m_rule->isValidMove(position, &scratch) || !scratch.placePiece(position, piece)) {
+            return false;
+        }
+        *decided = m_rule->checkWin(position, &scratch) || m_rule->isDraw(&scratch);
+    }
+    return true;
+}
+
+void GameEngine::replayGame(GameMode mode, const QVector<MoveIndex>& moves)
+{
+    emit replayStarted();
+    startNewGame(mode);
+    for (MoveIndex move : moves) {
+        const QPoint position = move.toPoint();
+        const ChessBoard::PieceType piece = (m_board->moveCount() % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+        m_board->placePiece(position, piece);
+        m_record.play(move);
+        emit moveMade(position, piece);
+    }
+    refreshPosition();
+    emit replayFinished();
+}
+
+bool GameEngine::canNavigate() const
+{
+    // 终局后仍可悔棋或翻看棋谱，退回到未分胜负的局面时对局继续
+    return m_state == Playing || m_state == Finished;
+}
+
+bool GameEngine::isAITurnAt(int node) const
+{
+    Player* player = m_players[m_record.node(node).ply % 2];
+    return m_mode == PvC && player && player->type() == Player::AI;
+}
+
+void GameEngine::replayTo(int node)
+{
+    // 正在思考的一方先停下，接下来的局面已经不是它要应对的了
+    Player* current = currentPlayerObject();
+    if (current) {
+        current->cancelMove();
+    }
+    
+    // 先退回共同祖先，再沿目标分支落子，只有两局面之间相差的几手被重放
+    emit replayStarted();
+    const GameRecord::Path path = m_record.pathTo(node);
+    for (int i = 0; i < path.undoCount; ++i) {
+        m_record.undo();
+        QPoint position = m_board->popMove();
+        emit moveUndone(position);
+    }
+    for (int id : path.forward) {
+        const GameRecord::Node& step = m_record.node(id);
+        const QPoint position = step.move.toPoint();
+        const ChessBoard::PieceType piece = (step.ply % 2 == 1) ? ChessBoard::Black : ChessBoard::White;
+        m_board->placePiece(position, piece);
+        m_record.play(step.move);
+        emit moveMade(position, piece);
+    }
+    
+    refreshPosition();
+    emit replayFinished();
+}
+
+void GameEngine::refreshPosition()
+{
+    m_currentPlayerIndex = m_board->moveCount() % 2;
+    
+    // 重新判断到达的局面；胜负已在当初落子时宣布过，这里不再发gameWon/gameDraw
+    GameRule::WinInfo winInfo;
+    const QPoint lastMove = m_board->lastMove();
+    if (m_board->hasHistory() && m_rule->checkWin(lastMove, m_board, &winInfo)) {
+        m_winner = winInfo.winner;
+        m_winLine = winInfo.line;
+    } else {
+        m_winner = ChessBoard::Empty;
+        m_winLine = GameRule::WinLine();
+    }
+    
+    const GameState state = (m_winner != ChessBoard::Empty || m_rule->isDraw(m_board)) ? Finished : Playing;
+    if (state != m_state || state == Finished) {
+        m_state = state;
+        emit gameStateChanged(m_state);
+    }
+    emit playerChanged(currentPlayer());
+    
+    requestPlayerMove();
+}
+
 void GameEngine::notifyGameEnd()
 {
     m_state = Finished;
@@ -5,6 +5,7 @@
 #include <QElapsedTimer>
 #include "ChessBoard.h"
 #include "GameRule.h"
+#include "GameRecord.h"
 #include "Player.h"
 
 class GameEngine : public QObject
@@ -24,17 +25,29 @@ public:
     void resumeGame();
     void endGame();
     void restartGame();
+    // 按给定落子序列重建一局棋，着法不合法时不做任何改动；
+    // restoreGame只接受还没分出胜负的对局，loadGame也接受已结束的对局，停在终局局面
+    bool restoreGame(GameMode mode, const QVector<MoveIndex>& moves);
+    bool loadGame(GameMode mode, const QVector<MoveIndex>& moves);
     
     // 下棋操作
     bool makeMove(const QPoint& position);
     bool undoMove();
+    bool redoMove();
     bool canUndo() const;
+    bool canRedo() const;
+    
+    // 棋谱导航：只重放当前局面与目标之间的差量，落子后从中途下出新的一手即成为变化
+    bool jumpToPly(int ply);
+    bool jumpToNode(int node);
+    const GameRecord& record() const { return m_record; }
     
     // 状态查询
     GameState gameState() const { return m_state; }
     GameMode gameMode() const { return m_mode; }
     ChessBoard::PieceType currentPlayer() const;
     ChessBoard::PieceType winner() const { return m_winner; }
+    const GameRule::WinLine& winningLine() const { return m_winLine; }
     bool isGameFinished() const { return m_state == Finished; }
     int moveCount() const;
     int undoCount() const { return m_undoCount; }
@@ -55,7 +68,12 @@ signals:
     void playerChanged(ChessBoard::PieceType player);
     void moveMade(const QPoint& position, ChessBoard::PieceType piece);
     void moveUndone(const QPoint& position);
-    void gameWon(ChessBoard::PieceType winner);
+    // 载入棋谱和棋谱导航一次重放多手，两信号之间的moveMade/moveUndone属于同一次重放，
+    // 需要逐步落盘的监听者可以等replayFinished后一次性处理
+    void replayStarted();
+    void replayFinished();
+    // line是判胜时一并得到的获胜棋子，界面直接用来高亮
+    void gameWon(ChessBoard::PieceType winner, const GameRule::WinLine& line);
     void gameDraw();
     void errorOccurred(const QString& message);
 
@@ -68,6 +86,12 @@ private:
     void setupPlayers();
     void switchPlayer();
     void checkGameEnd();
+    bool canNavigate() const;
+    bool isAITurnAt(int node) const;
+    void replayTo(int node);
+    void refreshPosition();
+    bool validateMoves(const QVector<MoveIndex>& moves, bool* decided) const;
+    void replayGame(GameMode mode, const QVector<MoveIndex>& moves);
     void notifyGameEnd();
     void requestPlayerMove();
     
@@ -78,6 +102,8 @@ private:
     GameMode m_mode;
     int m_currentPlayerIndex;
     ChessBoard::PieceType m_winner;
+    GameRule::WinLine m_winLine;
+    GameRecord m_record;
     QElapsedTimer m_gameTimer;
     int m_undoCount;
     int m_aiDifficulty;
@@ -0,0 +1,160 @@
+#include "GameRecord.h"
+#include <algorithm>
+
+const int GameRecord::ROOT;
+
+void GameRecord::clear()
+{
+    Node root;
+    root.move = MoveIndex();
+    root.ply = 0;
+    root.parent = -1;
+    root.firstChild = -1;
+    root.nextSibling = -1;
+    root.activeChild = -1;
+
+    m_nodes.clear();
+    m_nodes.append(root);
+    m_cursor = ROOT;
+}
+
+int GameRecord::play(MoveIndex move)
+{
+    Node& current = m_nodes[m_cursor];
+    int child = current.firstChild;
+    int lastChild = -1;
+    while (child >= 0 && m_nodes[child].move != move) {
+        lastChild = child;
+        child = m_nodes[child].nextSibling;
+    }
+
+    if (child < 0) {
+        Node node;
+        node.move = move;
+        node.ply = current.ply + 1;
+        node.parent = m_cursor;
+        node.firstChild = -1;
+        node.nextSibling = -1;
+        node.activeChild = -1;
+
+        // append可能让current失效，先记下要改的位置
+        child = m_nodes.size();
+        const int parent = m_cursor;
+        m_nodes.append(node);
+        if (lastChild >= 0) {
+            m_nodes[lastChild].nextSibling = child;
+        } else {
+            m_nodes[parent].firstChild = child;
+        }
+    }
+
+    m_nodes[m_cursor].activeChild = child;
+    m_cursor = child;
+    return child;
+}
+
+int GameRecord::undo()
+{
+    if (!canUndo()) {
+        return -1;
+    }
+
+    const int left = m_cursor;
+    m_cursor = m_nodes[left].parent;
+    m_nodes[m_cursor].activeChild = left;
+    return left;
+}
+
+int GameRecord::redo()
+{
+    if (!canRedo()) {
+        return -1;
+    }
+
+    m_cursor = m_nodes[m_cursor].activeChild;
+    return m_cursor;
+}
+
+int GameRecord::nodeAtPly(int ply) const
+{
+    if (ply < 0) {
+        return -1;
+    }
+
+    int id = m_cursor;
+    while (m_nodes[id].ply > ply) {
+        id = m_nodes[id].parent;
+    }
+    while (m_nodes[id].ply < ply) {
+        id = m_nodes[id].activeChild;
+        if (id < 0) {
+            return -1;
+        }
+    }
+    return id;
+}
+
+int GameRecord::lineLength() const
+{
+    int id = m_cursor;
+    while (m_nodes[id].activeChild >= 0) {
+        id = m_nodes[id].activeChild;
+    }
+    return m_nodes[id].ply;
+}
+
+GameRecord::Path GameRecord::pathTo(int target) const
+{
+    Path path;
+    path.undoCount = 0;
+    if (!isValidNode(target)) {
+        return path;
+    }
+
+    // 两端先走到同一深度，再一起向上直到汇合，经过的节点数正好是需要重放的差量
+    int from = m_cursor;
+    int to = target;
+    while (m_nodes[from].ply > m_nodes[to].ply) {
+        from = m_nodes[from].parent;
+        ++path.undoCount;
+    }
+    while (m_nodes[to].ply > m_nodes[from].ply) {
+        path.forward.append(to);
+        to = m_nodes[to].parent;
+    }
+    while (from != to) {
+        from = m_nodes[from].parent;
+        ++path.undoCount;
+        path.forward.append(to);
+        to = m_nodes[to].parent;
+    }
+    std::reverse(path.forward.begin(), path.forward.end());
+    return path;
+}
+
+QVector<int> GameRecord::variations(int id) const
+{
+    QVector<int> children;
+    if (!isValidNode(id)) {
+        return children;
+    }
+
+    for (int child = m_nodes[id].firstChild; child >= 0; child = m_nodes[child].nextSibling) {
+        children.append(child);
+    }
+    return children;
+}
+
+QVector<MoveIndex> GameRecord::line(int id) const
+{
+    QVector<MoveIndex> moves;
+    if (!isValidNode(id)) {
+        return moves;
+    }
+
+    moves.resize(m_nodes[id].ply);
+    for (; id != ROOT; id = m_nodes[id].parent) {
+        moves[m_nodes[id].ply - 1] = m_nodes[id].move;
+    }
+    return moves;
+}
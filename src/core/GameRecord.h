@@ -0,0 +1,70 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <QtGlobal>
+#include <QVector>
+#include "MoveIndex.h"
+
+// 只追加的棋谱记录：所有下过的着法组成一棵变化树，根节点是空棋盘。
+// 节点一经写入就不再修改或删除（只有活动分支指针会变），悔棋只是把游标移回父节点，
+// 重做沿活动分支前进，在中途落下不同的一手就自然形成新的变化。
+// 游标的每个祖先的活动分支都指向游标方向，所以当前分支总是包含游标。
+// 黑方先行，节点的棋子颜色由手数奇偶决定，不单独保存。
+class GameRecord
+{
+public:
+    static const int ROOT = 0;
+
+    struct Node {
+        MoveIndex move;       // 根节点为无效位置
+        int ply;              // 到这一手为止的步数，根节点为0
+        int parent;
+        int firstChild;
+        int nextSibling;
+        int activeChild;      // 重做时前进的方向：最近一次走过的子节点
+    };
+
+    // 从游标到目标节点的最短路径：先退回共同祖先，再依次前进
+    struct Path {
+        int undoCount;
+        QVector<int> forward;   // 按前进顺序排列的节点
+    };
+
+    GameRecord() { clear(); }
+
+    void clear();
+
+    int cursor() const { return m_cursor; }
+    int ply() const { return m_nodes[m_cursor].ply; }
+    int nodeCount() const { return m_nodes.size(); }
+    const Node& node(int id) const { return m_nodes[id]; }
+    bool isValidNode(int id) const { return id >= 0 && id < m_nodes.size(); }
+
+    // 在游标处落子并前进；已有相同着法的子节点时直接复用，不产生重复分支
+    int play(MoveIndex move);
+
+    bool canUndo() const { return m_cursor != ROOT; }
+    bool canRedo() const { return m_nodes[m_cursor].activeChild >= 0; }
+    // 以下两个函数返回离开或进入的节点，不能移动时返回-1
+    int undo();
+    int redo();
+
+    // 当前分支（根到游标，再沿活动分支到末端）上第ply手的节点，超出范围时返回-1
+    int nodeAtPly(int ply) const;
+    // 当前分支的总步数
+    int lineLength() const;
+
+    // 按返回的路径依次调用undo()和play()即可到达目标，每一步都是常数时间
+    Path pathTo(int target) const;
+
+    // 某个节点下的全部变化，第一个是最早下出的
+    QVector<int> variations(int id) const;
+    // 根到该节点的着法序列
+    QVector<MoveIndex> line(int id) const;
+
+private:
+    QVector<Node> m_nodes;
+    int m_cursor;
+};
+
+#endif // GAMERECORD_H
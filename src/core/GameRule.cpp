@@ -1,4 +1,5 @@
 #include "GameRule.h"
+#include <QtAlgorithms>
 
 // 定义四个检查方向：水平、垂直、主对角线、反对角线
 const QPoint GameRule::DIRECTIONS[4] = {
@@ -33,25 +34,42 @@ bool GameRule::checkWin(const QPoint& lastMove, const ChessBoard* board, WinInfo
         return false;
     }
     
-    // 检查四个方向
-    for (int i = 0; i < 4; ++i) {
-        if (checkDirection(lastMove, DIRECTIONS[i], piece, board)) {
-            if (winInfo) {
-                winInfo->type = static_cast<WinType>(i + 1);
-                winInfo->winner = piece;
-                
-                // 找到获胜线的起始和结束位置
-                QList<QPoint> line = getLineInDirection(lastMove, DIRECTIONS[i], piece, board);
-                if (!line.isEmpty()) {
-                    winInfo->startPos = line.first();
-                    winInfo->endPos = line.last();
+    // 经过该格的四个方向在位棋盘上一次检测完
+    int directions = board->lines().fiveDirections(MoveIndex::fromPoint(lastMove), piece);
+    if (directions == 0) {
+        return false;
+    }
+
+    if (winInfo) {
+        int i = qCountTrailingZeroBits(static_cast<quint32>(directions));
+        winInfo->type = static_cast<WinType>(i + 1);
+        winInfo->winner = piece;
+
+        // 连子两端直接由位棋盘上的连续位数得出，不再逐格回扫
+        LineBoard::LineRun runs[4];
+        board->lines().runsThrough(MoveIndex::fromPoint(lastMove), piece, runs);
+
+        // 每个方向按从起点到终点的顺序存放，落子点只在第一个方向里出现
+        WinLine& line = winInfo->line;
+        line.count = 0;
+        line.directions = directions;
+        for (int d = 0; d < 4; ++d) {
+            if (!(directions & (1 << d))) {
+                continue;
+            }
+            const QPoint start = lastMove - DIRECTIONS[d] * runs[d].before;
+            for (int k = 0; k < runs[d].length; ++k) {
+                if (k != runs[d].before || d == i) {
+                    line.stones[line.count++] = MoveIndex::fromPoint(start + DIRECTIONS[d] * k);
                 }
             }
-            return true;
+            if (d == i) {
+                winInfo->startPos = start;
+                winInfo->endPos = start + DIRECTIONS[d] * (runs[d].length - 1);
+            }
         }
     }
-    
-    return false;
+    return true;
 }
 
 bool GameRule::isDraw(const ChessBoard* board) const
@@ -60,28 +78,15 @@ bool GameRule::isDraw(const ChessBoard* board) const
         return false;
     }
     
-    return board->isFull();
+    // 棋盘下满，或者双方都已没有可能连五的窗口，都判和棋
+    return board->isFull() || board->isDeadPosition();
 }
 
-QList<QPoint> GameRule::getWinningLine(const QPoint& lastMove, const ChessBoard* board) const
+GameRule::WinLine GameRule::getWinningLine(const QPoint& lastMove, const ChessBoard* board) const
 {
-    if (!board || !board->isValidPosition(lastMove)) {
-        return QList<QPoint>();
-    }
-    
-    ChessBoard::PieceType piece = board->pieceAt(lastMove);
-    if (piece == ChessBoard::Empty) {
-        return QList<QPoint>();
-    }
-    
-    // 检查四个方向，找到获胜线
-    for (int i = 0; i < 4; ++i) {
-        if (checkDirection(lastMove, DIRECTIONS[i], piece, board)) {
-            return getLineInDirection(lastMove, DIRECTIONS[i], piece, board);
-        }
-    }
-    
-    return QList<QPoint>();
+    WinInfo winInfo;
+    checkWin(lastMove, board, &winInfo);
+    return winInfo.line;
 }
 
 int GameRule::countConsecutive(const QPoint& position, const QPoint& direction, 
@@ -91,6 +96,12 @@ int GameRule::countConsecutive(const QPoint& position, const QPoint& direction,
         return 0;
     }
     
+    // 四个标准方向直接查位棋盘，其余方向仍逐格遍历
+    LineBoard::Direction lineDirection;
+    if (board->isValidPosition(position) && directionOf(direction, &lineDirection)) {
+        return board->lines().runLength(MoveIndex::fromPoint(position), lineDirection, type);
+    }
+
     int count = 0;
     QPoint current = position;
     
@@ -110,34 +121,13 @@ int GameRule::countConsecutive(const QPoint& position, const QPoint& direction,
     return count;
 }
 
-bool GameRule::checkDirection(const QPoint& position, const QPoint& direction,
-                             ChessBoard::PieceType type, const ChessBoard* board) const
-{
-    return countConsecutive(position, direction, type, board) >= WIN_COUNT;
-}
-
-QList<QPoint> GameRule::getLineInDirection(const QPoint& position, const QPoint& direction,
-                                          ChessBoard::PieceType type, const ChessBoard* board) const
+bool GameRule::directionOf(const QPoint& direction, LineBoard::Direction* lineDirection)
 {
-    QList<QPoint> line;
-    
-    if (!board || type == ChessBoard::Empty) {
-        return line;
-    }
-    
-    // 向负方向找到起始点
-    QPoint start = position;
-    while (board->isValidPosition(start - direction) && 
-           board->pieceAt(start - direction) == type) {
-        start -= direction;
-    }
-    
-    // 从起始点向正方向收集所有相同类型的棋子
-    QPoint current = start;
-    while (board->isValidPosition(current) && board->pieceAt(current) == type) {
-        line.append(current);
-        current += direction;
+    for (int i = 0; i < 4; ++i) {
+        if (direction == DIRECTIONS[i]) {
+            *lineDirection = static_cast<LineBoard::Direction>(i);
+            return true;
+        }
     }
-    
-    return line;
-} 
\ No newline at end of file
+    return false;
+}
@@ -3,7 +3,7 @@
 
 #include <QObject>
 #include <QPoint>
-#include <QList>
+#include <algorithm>
 #include "ChessBoard.h"
 
 class GameRule : public QObject
@@ -14,11 +14,27 @@ public:
     enum WinType { None = 0, Horizontal = 1, Vertical = 2, 
                    DiagonalMain = 3, DiagonalAnti = 4 };
     
+    // 获胜的全部棋子，定长存放不分配内存
+    // 多个方向同时连五时依次包含每个方向的整条连子，落子点只记一次
+    struct WinLine {
+        static const int MAX_STONES = 4 * (MoveIndex::BOARD_SIZE - 1) + 1;
+        
+        MoveIndex stones[MAX_STONES];
+        int count;
+        int directions;   // 构成连五的方向位掩码(1 << LineBoard::Direction)
+        
+        WinLine() : count(0), directions(0) {}
+        bool isEmpty() const { return count == 0; }
+        bool contains(MoveIndex move) const { return std::find(stones, stones + count, move) != stones + count; }
+        bool contains(const QPoint& position) const { return contains(MoveIndex::fromPoint(position)); }
+    };
+    
     struct WinInfo {
-        WinType type;
-        QPoint startPos;
+        WinType type;        // 第一个连五方向
+        QPoint startPos;     // 该方向连子的两端
         QPoint endPos;
         ChessBoard::PieceType winner;
+        WinLine line;
         
         WinInfo() : type(None), startPos(-1, -1), endPos(-1, -1), winner(ChessBoard::Empty) {}
     };
@@ -31,15 +47,12 @@ public:
     bool isDraw(const ChessBoard* board) const;
     
     // 辅助功能
-    QList<QPoint> getWinningLine(const QPoint& lastMove, const ChessBoard* board) const;
+    WinLine getWinningLine(const QPoint& lastMove, const ChessBoard* board) const;
     int countConsecutive(const QPoint& position, const QPoint& direction, 
                         ChessBoard::PieceType type, const ChessBoard* board) const;
 
 private:
-    bool checkDirection(const QPoint& position, const QPoint& direction,
-                       ChessBoard::PieceType type, const ChessBoard* board) const;
-    QList<QPoint> getLineInDirection(const QPoint& position, const QPoint& direction,
-                                    ChessBoard::PieceType type, const ChessBoard* board) const;
+    static bool directionOf(const QPoint& direction, LineBoard::Direction* lineDirection);
     
     static const QPoint DIRECTIONS[4];
     static const int WIN_COUNT = 5;
@@ -0,0 +1,557 @@
+#include "LineBoard.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LINEBOARD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define LINEBOARD_TARGET(isa)
+#else
+#define LINEBOARD_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace {
+const int BOARD_SIZE = MoveIndex::BOARD_SIZE;
+
+enum PatternKind { FivePattern = 0, OpenFourPattern, FourPattern, OpenThreePattern, PATTERN_KINDS };
+
+// 每条线上真实存在的格子，补齐用的通道和对角线两端之外的位为0
+struct LaneMasks {
+    quint16 valid[LineBoard::LANE_COUNT];
+
+    LaneMasks()
+    {
+        std::memset(valid, 0, sizeof(valid));
+        const quint16 full = (1u << BOARD_SIZE) - 1;
+        for (int i = 0; i < BOARD_SIZE; ++i) {
+            valid[LineBoard::ROW_LANES + i] = full;
+            valid[LineBoard::COL_LANES + i] = full;
+        }
+        for (int row = 0; row < BOARD_SIZE; ++row) {
+            for (int col = 0; col < BOARD_SIZE; ++col) {
+                valid[LineBoard::DIAG_LANES + row - col + BOARD_SIZE - 1] |= 1u << col;
+                valid[LineBoard::ANTI_LANES + row + col] |= 1u << col;
+            }
+        }
+    }
+};
+
+const LaneMasks& laneMasks()
+{
+    static const LaneMasks masks;
+    return masks;
+}
+
+// 从bit开始向高位的连续1个数
+inline int onesFrom(quint32 mask, int bit)
+{
+    return static_cast<int>(qCountTrailingZeroBits(~(mask >> bit)));
+}
+
+// 从bit-1开始向低位的连续1个数
+inline int onesBelow(quint32 mask, int bit)
+{
+    return bit == 0 ? 0 : static_cast<int>(qCountLeadingZeroBits(~(mask << (32 - bit))));
+}
+
+// 覆盖bit的五格窗口的起点集合：[bit-4, bit]
+inline quint64 windowsThrough(int bit)
+{
+    return (0x1Fu << bit) >> 4;
+}
+
+using ScanKernel = void (*)(const quint16* own, const quint16* opp, const quint16* valid,
+                            quint32 counts[PATTERN_KINDS]);
+
+// 标量实现：逐条线做同样的移位与运算
+void scanScalar(const quint16* own, const quint16* opp, const quint16* valid, quint32 counts[PATTERN_KINDS])
+{
+    quint32 fives = 0, openFours = 0, fours = 0, openThrees = 0;
+    for (int i = 0; i < LineBoard::LANE_COUNT; ++i) {
+        const quint32 m = own[i];
+        const quint32 e = valid[i] & ~(own[i] | opp[i]);
+        if (m == 0) {
+            continue;
+        }
+
+        const quint32 m1 = m >> 1, m2 = m >> 2, m3 = m >> 3, m4 = m >> 4;
+        const quint32 e1 = e >> 1, e2 = e >> 2, e3 = e >> 3, e4 = e >> 4, e5 = e >> 5;
+
+        const quint32 five = m & m1 & m2 & m3 & m4;
+        const quint32 openFour = e & m1 & m2 & m3 & m4 & e5;
+        const quint32 four = (e & m1 & m2 & m3 & m4) | (m & e1 & m2 & m3 & m4) | (m & m1 & e2 & m3 & m4)
+                           | (m & m1 & m2 & e3 & m4) | (m & m1 & m2 & m3 & e4);
+        const quint32 openThree = (e & m1 & m2 & m3 & e4 & ((e << 1) | e5))
+                                | (e & m1 & e2 & m3 & m4 & e5)
+                                | (e & m1 & m2 & e3 & m4 & e5);
+
+        fives += qPopulationCount(five);
+        openFours += qPopulationCount(openFour);
+        fours += qPopulationCount(four);
+        openThrees += qPopulationCount(openThree);
+    }
+
+    counts[FivePattern] += fives;
+    counts[OpenFourPattern] += openFours;
+    counts[FourPattern] += fours;
+    counts[OpenThreePattern] += openThrees;
+}
+
+#ifdef LINEBOARD_X86
+// SSE4实现：每次处理8条线，16位通道内移位不会跨线
+LINEBOARD_TARGET("sse4.1")
+inline __m128i popcount128(__m128i x)
+{
+    const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(x, nibble));
+    __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+    return _mm_sad_epu8(_mm_add_epi8(lo, hi), _mm_setzero_si128());
+}
+
+LINEBOARD_TARGET("sse4.1")
+void scanSse4(const quint16* own, const quint16* opp, const quint16* valid, quint32 counts[PATTERN_KINDS])
+{
+    __m128i sums[PATTERN_KINDS];
+    for (__m128i& sum : sums) {
+        sum = _mm_setzero_si128();
+    }
+
+    for (int i = 0; i < LineBoard::LANE_COUNT; i += 8) {
+        const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(own + i));
+        const __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opp + i));
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valid + i));
+        if (_mm_testz_si128(m, m)) {
+            continue;
+        }
+        const __m128i e = _mm_andnot_si128(_mm_or_si128(m, o), v);
+
+        const __m128i m1 = _mm_srli_epi16(m, 1), m2 = _mm_srli_epi16(m, 2);
+        const __m128i m3 = _mm_srli_epi16(m, 3), m4 = _mm_srli_epi16(m, 4);
+        const __m128i e1 = _mm_srli_epi16(e, 1), e2 = _mm_srli_epi16(e, 2), e3 = _mm_srli_epi16(e, 3);
+        const __m128i e4 = _mm_srli_epi16(e, 4), e5 = _mm_srli_epi16(e, 5);
+
+        const __m128i m1234 = _mm_and_si128(_mm_and_si128(m1, m2), _mm_and_si128(m3, m4));
+        const __m128i m234 = _mm_and_si128(m2, _mm_and_si128(m3, m4));
+        const __m128i m01 = _mm_and_si128(m, m1);
+
+        const __m128i five = _mm_and_si128(m, m1234);
+        const __m128i openFour = _mm_and_si128(_mm_and_si128(e, m1234), e5);
+        __m128i four = _mm_and_si128(e, m1234);
+        four = _mm_or_si128(four, _mm_and_si128(_mm_and_si128(m, e1), m234));
+        four = _mm_or_si128(four, _mm_and_si128(_mm_and_si128(m01, e2), _mm_and_si128(m3, m4)));
+        four = _mm_or_si128(four, _mm_and_si128(_mm_and_si128(m01, m2), _mm_and_si128(e3, m4)));
+        four = _mm_or_si128(four, _mm_and_si128(_mm_and_si128(m01, m2), _mm_and_si128(m3, e4)));
+
+        const __m128i e05 = _mm_and_si128(e, e5);
+        __m128i openThree = _mm_and_si128(_mm_and_si128(_mm_and_si128(e, m1), _mm_and_si128(m2, m3)),
+                                          _mm_and_si128(e4, _mm_or_si128(_mm_slli_epi16(e, 1), e5)));
+        openThree = _mm_or_si128(openThree, _mm_and_si128(_mm_and_si128(e05, m1), _mm_and_si128(e2, _mm_and_si128(m3, m4))));
+        openThree = _mm_or_si128(openThree, _mm_and_si128(_mm_and_si128(e05, m1), _mm_and_si128(m2, _mm_and_si128(e3, m4))));
+
+        sums[FivePattern] = _mm_add_epi64(sums[FivePattern], popcount128(five));
+        sums[OpenFourPattern] = _mm_add_epi64(sums[OpenFourPattern], popcount128(openFour));
+        sums[FourPattern] = _mm_add_epi64(sums[FourPattern], popcount128(four));
+        sums[OpenThreePattern] = _mm_add_epi64(sums[OpenThreePattern], popcount128(openThree));
+    }
+
+    for (int k = 0; k < PATTERN_KINDS; ++k) {
+        counts[k] += static_cast<quint32>(_mm_cvtsi128_si32(sums[k]) + _mm_extract_epi32(sums[k], 2));
+    }
+}
+
+// AVX2实现：每次处理16条线，96条线共6次迭代
+LINEBOARD_TARGET("avx2")
+inline __m256i popcount256(__m256i x)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble));
+    __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+LINEBOARD_TARGET("avx2")
+inline quint32 horizontalSum(__m256i sum)
+{
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    return static_cast<quint32>(_mm_cvtsi128_si32(half) + _mm_extract_epi32(half, 2));
+}
+
+LINEBOARD_TARGET("avx2")
+void scanAvx2(const quint16* own, const quint16* opp, const quint16* valid, quint32 counts[PATTERN_KINDS])
+{
+    __m256i sums[PATTERN_KINDS];
+    for (__m256i& sum : sums) {
+        sum = _mm256_setzero_si256();
+    }
+
+    for (int i = 0; i < LineBoard::LANE_COUNT; i += 16) {
+        const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(own + i));
+        const __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(opp + i));
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valid + i));
+        if (_mm256_testz_si256(m, m)) {
+            continue;
+        }
+        const __m256i e = _mm256_andnot_si256(_mm256_or_si256(m, o), v);
+
+        const __m256i m1 = _mm256_srli_epi16(m, 1), m2 = _mm256_srli_epi16(m, 2);
+        const __m256i m3 = _mm256_srli_epi16(m, 3), m4 = _mm256_srli_epi16(m, 4);
+        const __m256i e1 = _mm256_srli_epi16(e, 1), e2 = _mm256_srli_epi16(e, 2), e3 = _mm256_srli_epi16(e, 3);
+        const __m256i e4 = _mm256_srli_epi16(e, 4), e5 = _mm256_srli_epi16(e, 5);
+
+        const __m256i m1234 = _mm256_and_si256(_mm256_and_si256(m1, m2), _mm256_and_si256(m3, m4));
+        const __m256i m234 = _mm256_and_si256(m2, _mm256_and_si256(m3, m4));
+        const __m256i m01 = _mm256_and_si256(m, m1);
+
+        const __m256i five = _mm256_and_si256(m, m1234);
+        const __m256i openFour = _mm256_and_si256(_mm256_and_si256(e, m1234), e5);
+        __m256i four = _mm256_and_si256(e, m1234);
+        four = _mm256_or_si256(four, _mm256_and_si256(_mm256_and_si256(m, e1), m234));
+        four = _mm256_or_si256(four, _mm256_and_si256(_mm256_and_si256(m01, e2), _mm256_and_si256(m3, m4)));
+        four = _mm256_or_si256(four, _mm256_and_si256(_mm256_and_si256(m01, m2), _mm256_and_si256(e3, m4)));
+        four = _mm256_or_si256(four, _mm256_and_si256(_mm256_and_si256(m01, m2), _mm256_and_si256(m3, e4)));
+
+        const __m256i e05 = _mm256_and_si256(e, e5);
+        __m256i openThree = _mm256_and_si256(_mm256_and_si256(_mm256_and_si256(e, m1), _mm256_and_si256(m2, m3)),
+                                             _mm256_and_si256(e4, _mm256_or_si256(_mm256_slli_epi16(e, 1), e5)));
+        openThree = _mm256_or_si256(openThree, _mm256_and_si256(_mm256_and_si256(e05, m1), _mm256_and_si256(e2, _mm256_and_si256(m3, m4))));
+        openThree = _mm256_or_si256(openThree, _mm256_and_si256(_mm256_and_si256(e05, m1), _mm256_and_si256(m2, _mm256_and_si256(e3, m4))));
+
+        sums[FivePattern] = _mm256_add_epi64(sums[FivePattern], popcount256(five));
+        sums[OpenFourPattern] = _mm256_add_epi64(sums[OpenFourPattern], popcount256(openFour));
+        sums[FourPattern] = _mm256_add_epi64(sums[FourPattern], popcount256(four));
+        sums[OpenThreePattern] = _mm256_add_epi64(sums[OpenThreePattern], popcount256(openThree));
+    }
+
+    for (int k = 0; k < PATTERN_KINDS; ++k) {
+        counts[k] += horizontalSum(sums[k]);
+    }
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasSse4()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif // LINEBOARD_X86
+
+struct KernelChoice {
+    ScanKernel scan;
+    const char* name;
+};
+
+struct CpuFeatures {
+    bool avx2;
+    bool sse4;
+
+    CpuFeatures()
+    {
+#ifdef LINEBOARD_X86
+        avx2 = cpuHasAvx2();
+        sse4 = cpuHasSse4();
+#else
+        avx2 = false;
+        sse4 = false;
+#endif
+    }
+};
+
+// 首次使用时检测CPU，之后不再检测
+const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features;
+    return features;
+}
+
+KernelChoice kernelFor(LineBoard::ScanPath path)
+{
+#ifdef LINEBOARD_X86
+    const CpuFeatures& cpu = cpuFeatures();
+    if ((path == LineBoard::AutoPath || path == LineBoard::Avx2Path) && cpu.avx2) {
+        return { scanAvx2, "avx2" };
+    }
+    if ((path == LineBoard::AutoPath || path == LineBoard::Sse4Path) && cpu.sse4) {
+        return { scanSse4, "sse4" };
+    }
+#else
+    Q_UNUSED(path)
+#endif
+    return { scanScalar, "scalar" };
+}
+
+const KernelChoice& kernel()
+{
+    static const KernelChoice choice = kernelFor(LineBoard::AutoPath);
+    return choice;
+}
+}
+
+void LineBoard::clear()
+{
+    std::memset(m_lanes, 0, sizeof(m_lanes));
+}
+
+void LineBoard::place(MoveIndex move, int piece)
+{
+    if (!move.isValid()) {
+        return;
+    }
+
+    quint16* lanes = m_lanes[colorIndex(piece)];
+    const int row = move.row();
+    const int col = move.col();
+    lanes[ROW_LANES + row] |= 1u << col;
+    lanes[COL_LANES + col] |= 1u << row;
+    lanes[DIAG_LANES + row - col + BOARD_SIZE - 1] |= 1u << col;
+    lanes[ANTI_LANES + row + col] |= 1u << col;
+}
+
+void LineBoard::remove(MoveIndex move)
+{
+    if (!move.isValid()) {
+        return;
+    }
+
+    const int row = move.row();
+    const int col = move.col();
+    for (quint16* lanes : m_lanes) {
+        lanes[ROW_LANES + row] &= ~(1u << col);
+        lanes[COL_LANES + col] &= ~(1u << row);
+        lanes[DIAG_LANES + row - col + BOARD_SIZE - 1] &= ~(1u << col);
+        lanes[ANTI_LANES + row + col] &= ~(1u << col);
+    }
+}
+
+int LineBoard::pieceAt(MoveIndex move) const
+{
+    if (!move.isValid()) {
+        return 0;
+    }
+
+    const quint16 bit = static_cast<quint16>(1u << move.col());
+    if (m_lanes[0][ROW_LANES + move.row()] & bit) {
+        return 1;
+    }
+    return (m_lanes[1][ROW_LANES + move.row()] & bit) ? 2 : 0;
+}
+
+int LineBoard::runLength(MoveIndex move, Direction direction, int piece) const
+{
+    if (!move.isValid()) {
+        return 0;
+    }
+
+    const quint32 mask = m_lanes[colorIndex(piece)][laneOf(move.row(), move.col(), direction)];
+    const int bit = bitOf(move.row(), move.col(), direction);
+    return onesFrom(mask, bit) + onesBelow(mask, bit);
+}
+
+LineBoard::LineRun LineBoard::runThrough(MoveIndex move, Direction direction, int piece) const
+{
+    if (!move.isValid()) {
+        LineRun run = { 0, 0, 0 };
+        return run;
+    }
+
+    const int color = colorIndex(piece);
+    const int lane = laneOf(move.row(), move.col(), direction);
+    return runInLane(m_lanes[color][lane], m_lanes[1 - color][lane], laneMasks().valid[lane],
+                     bitOf(move.row(), move.col(), direction));
+}
+
+void LineBoard::runsThrough(MoveIndex move, int piece, LineRun runs[4]) const
+{
+    if (!move.isValid()) {
+        for (int d = Horizontal; d <= DiagonalAnti; ++d) {
+            runs[d].length = 0;
+            runs[d].openEnds = 0;
+            runs[d].before = 0;
+        }
+        return;
+    }
+
+    const int row = move.row();
+    const int col = move.col();
+    const int lanes[4] = { ROW_LANES + row, COL_LANES + col,
+                           DIAG_LANES + row - col + BOARD_SIZE - 1, ANTI_LANES + row + col };
+    const int bits[4] = { col, row, col, col };
+    const quint16* own = m_lanes[colorIndex(piece)];
+    const quint16* opp = m_lanes[1 - colorIndex(piece)];
+    const quint16* valid = laneMasks().valid;
+
+    for (int d = Horizontal; d <= DiagonalAnti; ++d) {
+        runs[d] = runInLane(own[lanes[d]], opp[lanes[d]], valid[lanes[d]], bits[d]);
+    }
+}
+
+LineBoard::LineRun LineBoard::runInLane(quint32 own, quint32 opp, quint32 valid, int bit)
+{
+    own |= 1u << bit;
+    const quint32 empty = valid & ~(own | opp);
+    const int forward = onesFrom(own, bit);
+    const int backward = onesBelow(own, bit);
+
+    LineRun run;
+    run.length = forward + backward;
+    run.before = backward;
+    run.openEnds = static_cast<int>((empty >> (bit + forward)) & 1u);
+    if (bit - backward > 0) {
+        run.openEnds += static_cast<int>((empty >> (bit - backward - 1)) & 1u);
+    }
+    return run;
+}
+
+int LineBoard::fiveDirections(MoveIndex move, int piece) const
+{
+    if (!move.isValid()) {
+        return 0;
+    }
+
+    // 把经过该格的四条线拼成一个64位字，四个方向一次完成连五检测。
+    // 每条线的第15位恒为0，所以移位时从高一条线借入的位一定会被与掉，不会跨线误判。
+    const quint16* lanes = m_lanes[colorIndex(piece)];
+    const int row = move.row();
+    const int col = move.col();
+    const quint64 word = static_cast<quint64>(lanes[ROW_LANES + row])
+                       | static_cast<quint64>(lanes[COL_LANES + col]) << 16
+                       | static_cast<quint64>(lanes[DIAG_LANES + row - col + BOARD_SIZE - 1]) << 32
+                       | static_cast<quint64>(lanes[ANTI_LANES + row + col]) << 48;
+    const quint64 fives = word & (word >> 1) & (word >> 2) & (word >> 3) & (word >> 4);
+    const quint64 windows = windowsThrough(col)
+                          | windowsThrough(row) << 16
+                          | windowsThrough(col) << 32
+                          | windowsThrough(col) << 48;
+    const quint64 hits = fives & windows;
+
+    int directions = 0;
+    for (int d = Horizontal; d <= DiagonalAnti; ++d) {
+        if ((hits >> (16 * d)) & 0xFFFF) {
+            directions |= 1 << d;
+        }
+    }
+    return directions;
+}
+
+int LineBoard::liveWindows(int piece) const
+{
+    // 每次取四条线拼成64位字处理，96条线正好24次
+    const quint16* opp = m_lanes[1 - colorIndex(piece)];
+    const quint16* valid = laneMasks().valid;
+    int count = 0;
+    for (int lane = 0; lane < LANE_COUNT; lane += 4) {
+        quint64 oppWord = 0;
+        quint64 validWord = 0;
+        for (int i = 0; i < 4; ++i) {
+            oppWord |= static_cast<quint64>(opp[lane + i]) << (16 * i);
+            validWord |= static_cast<quint64>(valid[lane + i]) << (16 * i);
+        }
+        count += qPopulationCount(liveWindowStarts(oppWord, validWord));
+    }
+    return count;
+}
+
+int LineBoard::liveWindowsThrough(MoveIndex move, int piece) const
+{
+    if (!move.isValid()) {
+        return 0;
+    }
+
+    const quint16* opp = m_lanes[1 - colorIndex(piece)];
+    const quint16* valid = laneMasks().valid;
+    const int row = move.row();
+    const int col = move.col();
+    const int lanes[4] = { ROW_LANES + row, COL_LANES + col,
+                           DIAG_LANES + row - col + BOARD_SIZE - 1, ANTI_LANES + row + col };
+    quint64 oppWord = 0;
+    quint64 validWord = 0;
+    for (int d = Horizontal; d <= DiagonalAnti; ++d) {
+        oppWord |= static_cast<quint64>(opp[lanes[d]]) << (16 * d);
+        validWord |= static_cast<quint64>(valid[lanes[d]]) << (16 * d);
+    }
+    return qPopulationCount(liveWindowStarts(oppWord, validWord));
+}
+
+quint64 LineBoard::liveWindowStarts(quint64 opp, quint64 valid)
+{
+    // 与fiveDirections相同，每条线的第15位恒为0，窗口不会跨线
+    const quint64 open = valid & ~opp;
+    return open & (open >> 1) & (open >> 2) & (open >> 3) & (open >> 4);
+}
+
+LineBoard::PatternCounts LineBoard::scan(int piece, ScanPath path) const
+{
+    const int color = colorIndex(piece);
+    const ScanKernel scanKernel = (path == AutoPath) ? kernel().scan : kernelFor(path).scan;
+    quint32 counts[PATTERN_KINDS] = { 0, 0, 0, 0 };
+    scanKernel(m_lanes[color], m_lanes[1 - color], laneMasks().valid, counts);
+
+    PatternCounts result;
+    result.fives = static_cast<int>(counts[FivePattern]);
+    result.openFours = static_cast<int>(counts[OpenFourPattern]);
+    result.fours = static_cast<int>(counts[FourPattern]);
+    result.openThrees = static_cast<int>(counts[OpenThreePattern]);
+    return result;
+}
+
+const char* LineBoard::simdPath()
+{
+    return kernel().name;
+}
+
+bool LineBoard::isScanPathSupported(ScanPath path)
+{
+    switch (path) {
+        case Avx2Path: return cpuFeatures().avx2;
+        case Sse4Path: return cpuFeatures().sse4;
+        default:       return true;
+    }
+}
+
+int LineBoard::laneOf(int row, int col, Direction direction)
+{
+    switch (direction) {
+        case Horizontal:   return ROW_LANES + row;
+        case Vertical:     return COL_LANES + col;
+        case DiagonalMain: return DIAG_LANES + row - col + BOARD_SIZE - 1;
+        case DiagonalAnti: return ANTI_LANES + row + col;
+    }
+    return ROW_LANES + row;
+}
+
+int LineBoard::bitOf(int row, int col, Direction direction)
+{
+    return direction == Vertical ? row : col;
+}
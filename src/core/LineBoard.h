@@ -0,0 +1,87 @@
+#ifndef LINEBOARD_H
+#define LINEBOARD_H
+
+#include <QtGlobal>
+#include "MoveIndex.h"
+
+// 按“线”组织的位棋盘
+// 每种颜色保存96条16位线掩码：15行、15列、29条主对角线、29条反对角线（分别补齐到16/16/32/32条）。
+// 行、主对角线、反对角线以列号作为位序，列以行号作为位序，同一条线上相邻的格子在掩码中也相邻，
+// 因此连五、活四等棋型都可以用移位与运算在整条线上并行匹配，并按16位通道交给SIMD一次处理多条线。
+// 棋子类型参数与ChessBoard::PieceType取值一致：1=黑 2=白。
+class LineBoard
+{
+public:
+    enum Direction { Horizontal = 0, Vertical = 1, DiagonalMain = 2, DiagonalAnti = 3 };
+
+    // 整盘扫描的实现；AutoPath按运行时检测到的CPU特性选择，其余用于测试各实现结果一致
+    enum ScanPath { AutoPath = 0, Avx2Path, Sse4Path, ScalarPath };
+
+    // 通道布局
+    static const int ROW_LANES = 0;
+    static const int COL_LANES = 16;
+    static const int DIAG_LANES = 32;
+    static const int ANTI_LANES = 64;
+    static const int LANE_COUNT = 96;
+
+    // 整盘扫描得到的棋型数量（按五格窗口计数）
+    struct PatternCounts {
+        int fives;       // XXXXX
+        int openFours;   // _XXXX_
+        int fours;       // 五格窗口中四子一空：冲四和活四的威胁点
+        int openThrees;  // _XXX_ 外侧至少再有一个空位，以及 _X_XX_ / _XX_X_
+
+        PatternCounts() : fives(0), openFours(0), fours(0), openThrees(0) {}
+    };
+
+    // 经过某一格的连续棋子
+    struct LineRun {
+        int length;      // 连续同色棋子数（该格按己方棋子计算）
+        int openEnds;    // 两端紧邻的空位数(0-2)
+        int before;      // 其中位于move负方向的棋子数，连子从move往回数before格开始
+    };
+
+    LineBoard() { clear(); }
+
+    void clear();
+    void place(MoveIndex move, int piece);
+    void remove(MoveIndex move);
+    int pieceAt(MoveIndex move) const;
+
+    // 从move开始沿正方向的连续棋子数，加上move之前沿负方向的连续棋子数
+    // （与逐格遍历的countConsecutive语义一致，move本身不是该颜色时只计负方向）
+    int runLength(MoveIndex move, Direction direction, int piece) const;
+
+    // 假设move处放置piece后，经过move的连子长度和两端空位
+    LineRun runThrough(MoveIndex move, Direction direction, int piece) const;
+    // 同上，一次得到四个方向的结果，runs按Direction下标存放
+    void runsThrough(MoveIndex move, int piece, LineRun runs[4]) const;
+
+    // 一次检查经过move的四条线，返回构成连五的方向位掩码(1 << Direction)
+    int fiveDirections(MoveIndex move, int piece) const;
+
+    // piece仍可能连成五的五格窗口数（窗口内没有对方棋子）；空棋盘上为全部572个窗口
+    int liveWindows(int piece) const;
+    // 同上，只统计经过move的四条线，用于落子前后求差做增量维护
+    int liveWindowsThrough(MoveIndex move, int piece) const;
+
+    // 扫描全部行、列和对角线，统计piece的各类棋型；path指定的实现当前CPU不支持时退回标量实现
+    PatternCounts scan(int piece, ScanPath path = AutoPath) const;
+
+    const quint16* lanes(int piece) const { return m_lanes[colorIndex(piece)]; }
+
+    // 运行时选中的实现："avx2"、"sse4" 或 "scalar"
+    static const char* simdPath();
+    static bool isScanPathSupported(ScanPath path);
+
+private:
+    static int colorIndex(int piece) { return piece == 2 ? 1 : 0; }
+    static int laneOf(int row, int col, Direction direction);
+    static int bitOf(int row, int col, Direction direction);
+    static LineRun runInLane(quint32 own, quint32 opp, quint32 valid, int bit);
+    static quint64 liveWindowStarts(quint64 opp, quint64 valid);
+
+    quint16 m_lanes[2][LANE_COUNT];
+};
+
+#endif // LINEBOARD_H
@@ -0,0 +1,91 @@
+#ifndef MOVEINDEX_H
+#define MOVEINDEX_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QPoint>
+#include <bitset>
+
+// 紧凑落子编码：row * 15 + col，占1字节
+// 15x15棋盘共225个交叉点，0xFF表示无效位置
+class MoveIndex
+{
+public:
+    static const int BOARD_SIZE = 15;
+    static const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+    static const quint8 NONE = 0xFF;
+
+    constexpr MoveIndex() : m_value(NONE) {}
+    constexpr explicit MoveIndex(quint8 value) : m_value(value) {}
+
+    static constexpr MoveIndex fromRowCol(int row, int col)
+    {
+        return (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE)
+            ? MoveIndex(static_cast<quint8>(row * BOARD_SIZE + col))
+            : MoveIndex();
+    }
+
+    static constexpr MoveIndex fromPoint(const QPoint& position)
+    {
+        return fromRowCol(position.y(), position.x());
+    }
+
+    constexpr bool isValid() const { return m_value < CELL_COUNT; }
+    constexpr quint8 value() const { return m_value; }
+    constexpr int row() const { return m_value / BOARD_SIZE; }
+    constexpr int col() const { return m_value % BOARD_SIZE; }
+
+    QPoint toPoint() const
+    {
+        return isValid() ? QPoint(col(), row()) : QPoint(-1, -1);
+    }
+
+    constexpr bool operator==(MoveIndex other) const { return m_value == other.m_value; }
+    constexpr bool operator!=(MoveIndex other) const { return m_value != other.m_value; }
+    constexpr bool operator<(MoveIndex other) const { return m_value < other.m_value; }
+
+private:
+    quint8 m_value;
+};
+
+Q_DECLARE_TYPEINFO(MoveIndex, Q_PRIMITIVE_TYPE);
+
+inline uint qHash(MoveIndex key, uint seed = 0)
+{
+    return qHash(key.value(), seed);
+}
+
+// QPoint的hash：x和y分别占64位键的高低两半，避免 (a,b)/(b,a) 以及对角线上的点冲突
+inline uint qHash(const QPoint& key, uint seed = 0)
+{
+    quint64 packed = (static_cast<quint64>(static_cast<quint32>(key.x())) << 32)
+                   | static_cast<quint32>(key.y());
+    return qHash(packed, seed);
+}
+
+// 按MoveIndex直接寻址的位集合，替代QSet<QPoint>
+class MoveSet
+{
+public:
+    bool contains(MoveIndex move) const { return move.isValid() && m_bits.test(move.value()); }
+    void insert(MoveIndex move) { if (move.isValid()) m_bits.set(move.value()); }
+    void remove(MoveIndex move) { if (move.isValid()) m_bits.reset(move.value()); }
+    void clear() { m_bits.reset(); }
+    int size() const { return static_cast<int>(m_bits.count()); }
+    bool isEmpty() const { return m_bits.none(); }
+
+    // 插入并返回之前是否不存在
+    bool testAndInsert(MoveIndex move)
+    {
+        if (!move.isValid() || m_bits.test(move.value())) {
+            return false;
+        }
+        m_bits.set(move.value());
+        return true;
+    }
+
+private:
+    std::bitset<MoveIndex::CELL_COUNT> m_bits;
+};
+
+#endif // MOVEINDEX_H
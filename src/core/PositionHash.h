@@ -0,0 +1,62 @@
+#ifndef POSITIONHASH_H
+#define POSITIONHASH_H
+
+#include <QtGlobal>
+#include <algorithm>
+#include "MoveIndex.h"
+
+// 局面的Zobrist哈希
+// 每个(格子, 颜色)对应一个固定的64位键，局面哈希是全部棋子键的异或，落子和提子都只需异或一次。
+// 键由格子和颜色经splitmix64算出，不依赖随机种子，写进文件的哈希在不同进程之间保持一致。
+// 同时维护棋盘8种对称变换（旋转和翻转）下的哈希，取最小值作为规范哈希，互为对称的局面得到同一个值。
+class PositionHash
+{
+public:
+    static const int SYMMETRIES = 8;
+
+    PositionHash() { clear(); }
+
+    void clear() { std::fill(m_hashes, m_hashes + SYMMETRIES, 0); }
+
+    // 放置和移除棋子都调用它
+    void toggle(MoveIndex move, int piece)
+    {
+        for (int symmetry = 0; symmetry < SYMMETRIES; ++symmetry) {
+            m_hashes[symmetry] ^= key(transform(move, symmetry), piece);
+        }
+    }
+
+    quint64 value() const { return m_hashes[0]; }
+    quint64 canonical() const { return *std::min_element(m_hashes, m_hashes + SYMMETRIES); }
+
+    // piece与ChessBoard::PieceType取值一致：1=黑 2=白
+    static quint64 key(MoveIndex move, int piece)
+    {
+        quint64 z = (static_cast<quint64>(move.value()) * 3 + piece) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // symmetry的1、2、4三个位依次表示左右翻转、上下翻转、沿主对角线转置，0是恒等变换
+    static MoveIndex transform(MoveIndex move, int symmetry)
+    {
+        int row = move.row();
+        int col = move.col();
+        if (symmetry & 1) {
+            col = MoveIndex::BOARD_SIZE - 1 - col;
+        }
+        if (symmetry & 2) {
+            row = MoveIndex::BOARD_SIZE - 1 - row;
+        }
+        if (symmetry & 4) {
+            std::swap(row, col);
+        }
+        return MoveIndex::fromRowCol(row, col);
+    }
+
+private:
+    quint64 m_hashes[SYMMETRIES];
+};
+
+#endif // POSITIONHASH_H
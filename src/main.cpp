@@ -30,10 +30,6 @@ int main(int argc, char *argv[])
     QObject::connect(&app, &QApplication::aboutToQuit, [audioManager]() {
         qDebug() << "应用程序即将退出，停止背景音乐...";
         audioManager->stopBackgroundMusic();
-        // 确保清理所有afplay进程
-        #if defined(Q_OS_MAC)
-        system("killall afplay 2>/dev/null");
-        #endif
     });
     
     // 设置应用程序样式
@@ -51,9 +47,6 @@ int main(int argc, char *argv[])
     // 额外的清理确保
     qDebug() << "应用程序退出，执行最终清理...";
     audioManager->stopBackgroundMusic();
-    #if defined(Q_OS_MAC)
-    system("killall afplay 2>/dev/null");
-    #endif
     
     return result;
 } 
\ No newline at end of file
@@ -1,17 +1,75 @@
 #include "AudioManager.h"
 #include "managers/ConfigManager.h"
+#include "audio/AudioMixer.h"
+#include "audio/SoundSynthesizer.h"
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDir>
 #include <QUrl>
 #include <QApplication>
 #include <QFileInfo>
-#if defined(Q_OS_MAC)
-#include <QSound>
-#endif
+#include <QtConcurrent>
 
 AudioManager* AudioManager::s_instance = nullptr;
 
+namespace {
+// 换曲时的交叉淡化和停止时的淡出时长
+const int MUSIC_CROSSFADE_MS = 1500;
+const int MUSIC_FADE_OUT_MS = 300;
+
+// 默认音色：起始、时长、起止频率、波形、起音、衰减、噪声比例、音量
+SoundSynthesizer::Patch defaultPatch(AudioManager::SoundEffect effect)
+{
+    SoundSynthesizer::Patch patch;
+    switch (effect) {
+        case AudioManager::PiecePlaced:
+            // 落子：短促的木质敲击，噪声起头再接一个快速下滑的低音
+            patch.tones = {
+                { 0.0f, 12.0f, 2400.0f, 1800.0f, SoundSynthesizer::Sine, 0.3f, 3.0f, 0.7f, 0.6f },
+                { 0.0f, 70.0f, 620.0f, 420.0f, SoundSynthesizer::Sine, 0.5f, 14.0f, 0.05f, 1.0f }
+            };
+            break;
+        case AudioManager::ButtonClick:
+            patch.tones = {
+                { 0.0f, 30.0f, 1600.0f, 1400.0f, SoundSynthesizer::Sine, 0.5f, 6.0f, 0.15f, 1.0f }
+            };
+            patch.gain = 0.5f;
+            break;
+        case AudioManager::GameWon:
+            // 获胜：C大调上行琶音，最后一个音延长
+            patch.tones = {
+                { 0.0f, 180.0f, 523.25f, 523.25f, SoundSynthesizer::Triangle, 5.0f, 120.0f, 0.0f, 0.8f },
+                { 110.0f, 180.0f, 659.25f, 659.25f, SoundSynthesizer::Triangle, 5.0f, 120.0f, 0.0f, 0.8f },
+                { 220.0f, 180.0f, 783.99f, 783.99f, SoundSynthesizer::Triangle, 5.0f, 120.0f, 0.0f, 0.8f },
+                { 330.0f, 520.0f, 1046.5f, 1046.5f, SoundSynthesizer::Triangle, 5.0f, 260.0f, 0.0f, 1.0f }
+            };
+            break;
+        case AudioManager::GameDraw:
+            // 和棋：两个平稳的中音
+            patch.tones = {
+                { 0.0f, 260.0f, 587.33f, 587.33f, SoundSynthesizer::Sine, 8.0f, 180.0f, 0.0f, 0.8f },
+                { 200.0f, 360.0f, 493.88f, 493.88f, SoundSynthesizer::Sine, 8.0f, 220.0f, 0.0f, 0.8f }
+            };
+            break;
+        case AudioManager::Undo:
+            patch.tones = {
+                { 0.0f, 140.0f, 880.0f, 440.0f, SoundSynthesizer::Triangle, 3.0f, 70.0f, 0.0f, 1.0f }
+            };
+            patch.gain = 0.6f;
+            break;
+        case AudioManager::Error:
+            // 错误：两声低沉的蜂鸣
+            patch.tones = {
+                { 0.0f, 110.0f, 180.0f, 170.0f, SoundSynthesizer::Square, 2.0f, 0.0f, 0.0f, 0.8f },
+                { 150.0f, 160.0f, 150.0f, 140.0f, SoundSynthesizer::Square, 2.0f, 0.0f, 0.0f, 0.8f }
+            };
+            patch.gain = 0.6f;
+            break;
+    }
+    return patch;
+}
+}
+
 AudioManager* AudioManager::instance()
 {
     if (!s_instance) {
@@ -24,7 +82,8 @@ AudioManager::AudioManager(QObject *parent)
     : QObject(parent)
     , m_masterVolume(0.7f)
     , m_muted(false)
-    , m_backgroundMusic(nullptr)
+    , m_mixer(nullptr)
+    , m_synthWatcher(nullptr)
 {
     initializeAudio();
 }
@@ -37,10 +96,19 @@ AudioManager::~AudioManager()
 
 void AudioManager::initializeAudio()
 {
-    // 初始化背景音乐播放器
-    m_backgroundMusic = new QMediaPlayer(this);
-    m_backgroundPlaylist = new QMediaPlaylist(this);
-    m_backgroundMusic->setPlaylist(m_backgroundPlaylist);
+    // 音效混音器，样本要按它实际使用的采样率解码，所以先启动
+    m_mixer = new AudioMixer(this);
+    m_mixer->setEffectGain(m_masterVolume);
+    if (!m_mixer->start()) {
+        qDebug() << "Audio mixer unavailable, falling back to system beep";
+    }
+    
+    // 音乐音量调整后立即生效
+    ConfigManager* configManager = ConfigManager::instance();
+    m_mixer->setMusicGain(configManager->musicVolume());
+    connect(configManager, &ConfigManager::musicVolumeChanged, this, [this](float volume) {
+        m_mixer->setMusicGain(volume);
+    });
     
     // 创建默认音效
     createDefaultSounds();
@@ -48,16 +116,67 @@ void AudioManager::initializeAudio()
 
 void AudioManager::createDefaultSounds()
 {
-    // 由于没有实际音频文件，我们创建简单的提示音效
-    // 在实际项目中，这里会加载真实的音频文件
+    if (!m_mixer->isRunning()) {
+        return;
+    }
+    
+    #if defined(Q_OS_MAC)
+    // 在macOS上使用系统声音，启动时解码成PCM，之后播放不再读文件
+    const QMap<SoundEffect, QString> soundFiles = {
+        { PiecePlaced, "/System/Library/Sounds/Tink.aiff" },
+        { GameWon, "/System/Library/Sounds/Glass.aiff" },
+        { GameDraw, "/System/Library/Sounds/Sosumi.aiff" },
+        { ButtonClick, "/System/Library/Sounds/Pop.aiff" },
+        { Undo, "/System/Library/Sounds/Funk.aiff" },
+        { Error, "/System/Library/Sounds/Basso.aiff" }
+    };
+    
+    for (auto it = soundFiles.constBegin(); it != soundFiles.constEnd(); ++it) {
+        PcmBuffer pcm;
+        if (PcmCodec::decodeFile(it.value(), m_mixer->sampleRate(), &pcm)) {
+            m_effectSamples.insert(it.key(), m_mixer->addSample(pcm));
+        } else {
+            qDebug() << "Failed to decode sound:" << it.value();
+        }
+    }
+    #endif
     
-    for (int i = 0; i < 6; ++i) {
-        QSoundEffect* effect = new QSoundEffect(this);
-        // 这里应该设置音频文件路径
-        // effect->setSource(QUrl::fromLocalFile(":/sounds/effect.wav"));
-        effect->setVolume(m_masterVolume);
-        m_soundEffects.insert(static_cast<SoundEffect>(i), effect);
+    // 其余音效使用程序合成的默认音色，合成或读缓存都在后台线程进行，不拖慢启动
+    QMap<int, SoundSynthesizer::Patch> patches;
+    for (int i = PiecePlaced; i <= Error; ++i) {
+        const SoundEffect effect = static_cast<SoundEffect>(i);
+        if (!m_effectSamples.contains(effect)) {
+            patches.insert(i, defaultPatch(effect));
+        }
+    }
+    if (patches.isEmpty()) {
+        return;
+    }
+    
+    const int sampleRate = m_mixer->sampleRate();
+    m_synthWatcher = new QFutureWatcher<QMap<int, PcmBuffer>>(this);
+    connect(m_synthWatcher, &QFutureWatcherBase::finished, this, &AudioManager::onDefaultSoundsReady);
+    m_synthWatcher->setFuture(QtConcurrent::run([patches, sampleRate]() {
+        QMap<int, PcmBuffer> samples;
+        for (auto it = patches.constBegin(); it != patches.constEnd(); ++it) {
+            PcmBuffer pcm;
+            if (PcmCodec::decode(SoundSynthesizer::cachedWav(it.value(), sampleRate), sampleRate, &pcm)) {
+                samples.insert(it.key(), pcm);
+            }
+        }
+        return samples;
+    }));
+}
+
+void AudioManager::onDefaultSoundsReady()
+{
+    // 样本注册必须在界面线程进行，和playEffect共用同一个生产者
+    const QMap<int, PcmBuffer> samples = m_synthWatcher->result();
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+        m_effectSamples.insert(static_cast<SoundEffect>(it.key()), m_mixer->addSample(it.value()));
     }
+    m_synthWatcher->deleteLater();
+    m_synthWatcher = nullptr;
 }
 
 void AudioManager::playEffect(SoundEffect effect)
@@ -88,55 +207,20 @@ void AudioManager::playEffect(SoundEffect effect)
             break;
     }
     
-    // 播放系统提示音
-    if (!m_muted) {
-        // 在macOS上播放系统声音
-        #if defined(Q_OS_MAC)
-        QString soundFile;
-        switch (effect) {
-            case PiecePlaced:
-                soundFile = "/System/Library/Sounds/Tink.aiff";
-                break;
-            case GameWon:
-                soundFile = "/System/Library/Sounds/Glass.aiff";
-                break;
-            case GameDraw:
-                soundFile = "/System/Library/Sounds/Sosumi.aiff";
-                break;
-            case ButtonClick:
-                soundFile = "/System/Library/Sounds/Pop.aiff";
-                break;
-            case Undo:
-                soundFile = "/System/Library/Sounds/Funk.aiff";
-                break;
-            case Error:
-                soundFile = "/System/Library/Sounds/Basso.aiff";
-                break;
-        }
-        
-        if (!soundFile.isEmpty()) {
-            QString command = QString("afplay \"%1\" &").arg(soundFile);
-            system(command.toUtf8().constData());
-        }
-        #else
-        // 其他平台使用系统提示音
-        QApplication::beep();
-        #endif
+    // 只是向混音线程发一条命令，不会阻塞界面
+    const int sampleId = m_effectSamples.value(effect, -1);
+    if (m_mixer->isRunning() && m_mixer->hasSample(sampleId)) {
+        m_mixer->play(sampleId);
+        return;
     }
     
-    // 播放音效（如果有音频文件的话）
-    if (m_soundEffects.contains(effect)) {
-        QSoundEffect* soundEffect = m_soundEffects[effect];
-        if (soundEffect && soundEffect->isLoaded()) {
-            soundEffect->setVolume(m_masterVolume);
-            soundEffect->play();
-        }
-    }
+    // 没有输出设备，或默认音色还在合成时使用系统提示音
+    QApplication::beep();
 }
 
 void AudioManager::playBackgroundMusic()
 {
-    if (m_muted || !m_backgroundMusic) {
+    if (m_muted) {
         return;
     }
     
@@ -144,43 +228,18 @@ void AudioManager::playBackgroundMusic()
     QString musicPath = configManager->backgroundMusic();
     
     if (!musicPath.isEmpty() && QFileInfo::exists(musicPath)) {
-        qDebug() << "Starting background music:" << musicPath;
-        
-        // 在macOS上使用系统播放器
-        #if defined(Q_OS_MAC)
-        // 停止当前播放
-        stopBackgroundMusic();
-        
-        // 使用afplay播放背景音乐（循环播放）
-        float musicVolume = configManager->musicVolume();
-        int volumePercent = static_cast<int>(musicVolume * 100);
-        
-        // 添加标识符以便于管理进程
-        QString command = QString("nohup sh -c 'while true; do afplay -v %1 \"%2\" 2>/dev/null; done' >/dev/null 2>&1 &")
-                         .arg(musicVolume)
-                         .arg(musicPath);
-        system(command.toUtf8().constData());
-        
-        qDebug() << "Background music started with volume:" << volumePercent << "%";
-        #else
-        // 其他平台使用Qt播放器
-        // 清空播放列表并添加新音乐
-        m_backgroundPlaylist->clear();
-        m_backgroundPlaylist->addMedia(QUrl::fromLocalFile(musicPath));
-        
-        // 设置音量（使用音乐专用音量设置）
-        float musicVolume = configManager->musicVolume();
-        m_backgroundMusic->setVolume(musicVolume * 100); // QMediaPlayer使用0-100范围
-        
-        m_backgroundPlaylist->setPlaybackMode(QMediaPlaylist::Loop);
-        m_backgroundMusic->play();
+        // 同一首已经在播放时继续播放，换曲时与上一首交叉淡化
+        if (musicPath == m_musicPath) {
+            return;
+        }
         
-        // 添加错误处理
-        connect(m_backgroundMusic, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error),
-                [=](QMediaPlayer::Error error) {
-                    qDebug() << "Background music error:" << error << m_backgroundMusic->errorString();
-                });
-        #endif
+        m_mixer->setMusicGain(configManager->musicVolume());
+        if (m_mixer->playMusic(musicPath, true, MUSIC_CROSSFADE_MS)) {
+            m_musicPath = musicPath;
+            qDebug() << "Starting background music:" << musicPath;
+        } else {
+            qDebug() << "Failed to start background music:" << musicPath;
+        }
     } else {
         qDebug() << "No valid background music file configured";
     }
@@ -188,44 +247,21 @@ void AudioManager::playBackgroundMusic()
 
 void AudioManager::stopBackgroundMusic()
 {
-    #if defined(Q_OS_MAC)
-    // 在macOS上停止afplay进程，包括相关的shell进程
-    system("pkill -f \"while true.*afplay\" 2>/dev/null");
-    system("killall afplay 2>/dev/null");
-    system("pkill -f \"nohup sh.*afplay\" 2>/dev/null");
-    qDebug() << "Background music stopped (afplay)";
-    #endif
-    
-    if (m_backgroundMusic) {
-        m_backgroundMusic->stop();
-        qDebug() << "Background music stopped (Qt)";
+    if (m_mixer) {
+        m_mixer->stopMusic(MUSIC_FADE_OUT_MS);
+        m_mixer->setMusicPaused(false);
     }
+    m_musicPath.clear();
 }
 
 void AudioManager::pauseBackgroundMusic()
 {
-    #if defined(Q_OS_MAC)
-    system("killall -STOP afplay 2>/dev/null");
-    qDebug() << "Background music paused (afplay)";
-    #endif
-    
-    if (m_backgroundMusic) {
-        m_backgroundMusic->pause();
-        qDebug() << "Background music paused (Qt)";
-    }
+    m_mixer->setMusicPaused(true);
 }
 
 void AudioManager::resumeBackgroundMusic()
 {
-    #if defined(Q_OS_MAC)
-    system("killall -CONT afplay 2>/dev/null");
-    qDebug() << "Background music resumed (afplay)";
-    #endif
-    
-    if (m_backgroundMusic) {
-        m_backgroundMusic->play();
-        qDebug() << "Background music resumed (Qt)";
-    }
+    m_mixer->setMusicPaused(false);
 }
 
 void AudioManager::setMasterVolume(float volume)
@@ -236,19 +272,11 @@ void AudioManager::setMasterVolume(float volume)
     if (m_masterVolume != volume) {
         m_masterVolume = volume;
         
-        // 更新所有音效的音量
-        for (auto it = m_soundEffects.begin(); it != m_soundEffects.end(); ++it) {
-            if (it.value()) {
-                it.value()->setVolume(volume);
-            }
-        }
+        // 更新音效音量，混音线程在下一个缓冲周期生效
+        m_mixer->setEffectGain(volume);
         
         // 更新背景音乐音量（使用专用的音乐音量设置）
-        if (m_backgroundMusic) {
-            ConfigManager* configManager = ConfigManager::instance();
-            float musicVolume = configManager->musicVolume();
-            m_backgroundMusic->setVolume(musicVolume * 100);
-        }
+        m_mixer->setMusicGain(ConfigManager::instance()->musicVolume());
         
         emit volumeChanged(volume);
     }
@@ -258,6 +286,9 @@ void AudioManager::setMuted(bool muted)
 {
     if (m_muted != muted) {
         m_muted = muted;
+        if (muted) {
+            m_mixer->stopAll();
+        }
         emit mutedChanged(muted);
     }
 } 
\ No newline at end of file
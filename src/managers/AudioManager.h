@@ -2,10 +2,11 @@
 #define AUDIOMANAGER_H
 
 #include <QObject>
-#include <QSoundEffect>
-#include <QMediaPlayer>
-#include <QMediaPlaylist>
 #include <QMap>
+#include <QFutureWatcher>
+
+class AudioMixer;
+struct PcmBuffer;
 
 // 音频管理器
 class AudioManager : public QObject
@@ -45,6 +46,9 @@ signals:
     void volumeChanged(float volume);
     void mutedChanged(bool muted);
 
+private slots:
+    void onDefaultSoundsReady();
+
 private:
     explicit AudioManager(QObject *parent = nullptr);
     ~AudioManager();
@@ -54,12 +58,13 @@ private:
     float m_masterVolume;
     bool m_muted;
     
-    // 音效
-    QMap<SoundEffect, QSoundEffect*> m_soundEffects;
+    // 音效：样本启动时解码一次，播放时交给混音线程
+    AudioMixer* m_mixer;
+    QMap<SoundEffect, int> m_effectSamples;
+    QFutureWatcher<QMap<int, PcmBuffer>>* m_synthWatcher;
     
-    // 背景音乐
-    QMediaPlayer* m_backgroundMusic;
-    QMediaPlaylist* m_backgroundPlaylist;
+    // 背景音乐：由混音器流式播放，这里只记录正在播放的文件
+    QString m_musicPath;
     
     static AudioManager* s_instance;
 };
@@ -95,6 +95,7 @@ bool ConfigManager::autoSave() const
 void ConfigManager::setAutoSave(bool enabled)
 {
     m_settings->setValue("Game/AutoSave", enabled);
+    emit autoSaveChanged(enabled);
 }
 
 QString ConfigManager::backgroundImage() const
@@ -118,6 +119,17 @@ void ConfigManager::setBackgroundOpacity(float opacity)
     m_settings->setValue("Display/BackgroundOpacity", opacity);
 }
 
+QString ConfigManager::renderer() const
+{
+    return m_settings->value("Display/Renderer", "raster").toString();
+}
+
+void ConfigManager::setRenderer(const QString& renderer)
+{
+    m_settings->setValue("Display/Renderer", renderer);
+    emit rendererChanged(renderer);
+}
+
 QString ConfigManager::theme() const
 {
     return m_settings->value("Display/Theme", "classic").toString();
@@ -170,6 +182,7 @@ float ConfigManager::musicVolume() const
 void ConfigManager::setMusicVolume(float volume)
 {
     m_settings->setValue("Audio/MusicVolume", volume);
+    emit musicVolumeChanged(volume);
 }
 
 bool ConfigManager::soundEffectsEnabled() const
@@ -37,6 +37,10 @@ public:
     float backgroundOpacity() const;
     void setBackgroundOpacity(float opacity);
     
+    // 棋盘渲染器："raster"（默认）或"opengl"
+    QString renderer() const;
+    void setRenderer(const QString& renderer);
+    
     QString theme() const;
     void setTheme(const QString& theme);
     
@@ -68,12 +72,15 @@ public:
 signals:
     void gameModeChanged(GameEngine::GameMode mode);
     void aiDifficultyChanged(int difficulty);
+    void autoSaveChanged(bool enabled);
     void showCoordinatesChanged(bool show);
     void backgroundImageChanged(const QString& path);
     void backgroundMusicChanged(const QString& path);
     void volumeChanged(float volume);
+    void musicVolumeChanged(float volume);
     void languageChanged(const QString& language);
     void themeChanged(const QString& theme);
+    void rendererChanged(const QString& renderer);
 
 private:
     explicit ConfigManager(QObject *parent = nullptr);
@@ -0,0 +1,261 @@
+#include "GameJournal.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QDebug>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const int GameJournal::COMPACT_INTERVAL;
+
+namespace {
+// 快照：4字节魔数和版本，1字节对局模式，1字节步数，之后每步1字节
+const char JOURNAL_MAGIC[] = "GBJ";
+const char JOURNAL_VERSION = 1;
+const int HEADER_SIZE = 6;
+const int RECORD_SIZE = 2;
+
+bool syncToDisk(QFile* file)
+{
+    if (!file->flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file->handle()) == 0;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+}
+}
+
+GameJournal::GameJournal(QObject* parent)
+    : QObject(parent)
+    , m_gameEngine(nullptr)
+    , m_file(nullptr)
+    , m_enabled(false)
+    , m_restoring(false)
+    , m_replaying(false)
+    , m_records(0)
+{
+}
+
+GameJournal::~GameJournal()
+{
+    close();
+}
+
+void GameJournal::setGameEngine(GameEngine* engine)
+{
+    if (m_gameEngine) {
+        disconnect(m_gameEngine, nullptr, this, nullptr);
+    }
+    close();
+
+    m_gameEngine = engine;
+
+    if (m_gameEngine) {
+        connect(m_gameEngine, &GameEngine::moveMade,
+                this, &GameJournal::onMoveMade);
+        connect(m_gameEngine, &GameEngine::moveUndone,
+                this, &GameJournal::onMoveUndone);
+        connect(m_gameEngine, &GameEngine::gameStateChanged,
+                this, &GameJournal::onGameStateChanged);
+        connect(m_gameEngine, &GameEngine::replayStarted,
+                this, &GameJournal::onReplayStarted);
+        connect(m_gameEngine, &GameEngine::replayFinished,
+                this, &GameJournal::onReplayFinished);
+    }
+}
+
+void GameJournal::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+
+    m_enabled = enabled;
+    if (!m_enabled) {
+        close();
+        QFile::remove(journalPath());
+    } else if (m_gameEngine && m_gameEngine->gameState() != GameEngine::Ready) {
+        compact();
+    }
+}
+
+bool GameJournal::restore()
+{
+    if (!m_enabled || !m_gameEngine) {
+        return false;
+    }
+
+    QFile file(journalPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    GameEngine::GameMode mode;
+    QVector<MoveIndex> moves;
+    if (!parse(file.readAll(), &mode, &moves) || moves.isEmpty()) {
+        return false;
+    }
+    file.close();
+
+    // 恢复过程中引擎发出的信号不再写回日志，完成后整体重写成快照，顺带去掉可能写坏的尾部
+    m_restoring = true;
+    const bool restored = m_gameEngine->restoreGame(mode, moves);
+    m_restoring = false;
+    if (restored) {
+        compact();
+    }
+    return restored;
+}
+
+QString GameJournal::journalPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/autosave.journal";
+}
+
+void GameJournal::onMoveMade(const QPoint& position, ChessBoard::PieceType piece)
+{
+    Q_UNUSED(piece)
+    append(MoveRecord, position);
+}
+
+void GameJournal::onMoveUndone(const QPoint& position)
+{
+    append(UndoRecord, position);
+}
+
+void GameJournal::onGameStateChanged(GameEngine::GameState state)
+{
+    if (!m_enabled || m_restoring || m_replaying) {
+        return;
+    }
+
+    // 新对局开始时用空快照覆盖上一局的日志
+    if (state == GameEngine::Playing && (!m_file || m_gameEngine->moveCount() == 0)) {
+        compact();
+    }
+}
+
+void GameJournal::onReplayStarted()
+{
+    m_replaying = true;
+}
+
+void GameJournal::onReplayFinished()
+{
+    m_replaying = false;
+
+    // 重放的结果整体写成一份快照，代替逐手追加和fsync；恢复时由restore自己写快照
+    if (m_enabled && !m_restoring) {
+        compact();
+    }
+}
+
+void GameJournal::append(RecordType type, const QPoint& position)
+{
+    if (!m_enabled || m_restoring || m_replaying) {
+        return;
+    }
+
+    // 信号在棋盘更新之后发出，这时压缩得到的快照已经包含这一步
+    if (!m_file || ++m_records >= COMPACT_INTERVAL) {
+        compact();
+        return;
+    }
+
+    const char record[RECORD_SIZE] = {
+        static_cast<char>(type),
+        static_cast<char>(MoveIndex::fromPoint(position).value())
+    };
+    if (m_file->write(record, RECORD_SIZE) != RECORD_SIZE || !syncToDisk(m_file)) {
+        qWarning() << "Failed to append to autosave journal:" << m_file->errorString();
+        close();
+    }
+}
+
+bool GameJournal::compact()
+{
+    close();
+    if (!m_gameEngine) {
+        return false;
+    }
+
+    const ChessBoard::HistoryView history = m_gameEngine->chessBoard()->history();
+    QByteArray snapshot;
+    snapshot.reserve(HEADER_SIZE + history.size());
+    snapshot.append(JOURNAL_MAGIC, 3);
+    snapshot.append(JOURNAL_VERSION);
+    snapshot.append(static_cast<char>(m_gameEngine->gameMode()));
+    snapshot.append(static_cast<char>(history.size()));
+    for (MoveIndex move : history) {
+        snapshot.append(static_cast<char>(move.value()));
+    }
+
+    const QString path = journalPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile output(path);
+    if (!output.open(QIODevice::WriteOnly) || output.write(snapshot) != snapshot.size() || !output.commit()) {
+        qWarning() << "Failed to write autosave snapshot:" << output.errorString();
+        return false;
+    }
+
+    m_file = new QFile(path);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to open autosave journal:" << m_file->errorString();
+        close();
+        return false;
+    }
+    m_records = 0;
+    return true;
+}
+
+void GameJournal::close()
+{
+    delete m_file;
+    m_file = nullptr;
+}
+
+bool GameJournal::parse(const QByteArray& data, GameEngine::GameMode* mode, QVector<MoveIndex>* moves)
+{
+    if (data.size() < HEADER_SIZE || !data.startsWith(JOURNAL_MAGIC) || data[3] != JOURNAL_VERSION) {
+        return false;
+    }
+
+    const int modeValue = static_cast<quint8>(data[4]);
+    const int count = static_cast<quint8>(data[5]);
+    if (modeValue > GameEngine::Network || data.size() < HEADER_SIZE + count) {
+        return false;
+    }
+    *mode = static_cast<GameEngine::GameMode>(modeValue);
+
+    moves->clear();
+    for (int i = 0; i < count; ++i) {
+        const MoveIndex move(static_cast<quint8>(data[HEADER_SIZE + i]));
+        if (!move.isValid()) {
+            return false;
+        }
+        moves->append(move);
+    }
+
+    // 快照之后的追加记录；最后一条可能只写了一半，遇到不完整或对不上的记录就停下
+    for (int offset = HEADER_SIZE + count; offset + RECORD_SIZE <= data.size(); offset += RECORD_SIZE) {
+        const char type = data[offset];
+        const MoveIndex move(static_cast<quint8>(data[offset + 1]));
+        if (type == MoveRecord && move.isValid()) {
+            moves->append(move);
+        } else if (type == UndoRecord && !moves->isEmpty() && moves->last() == move) {
+            moves->removeLast();
+        } else {
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef GAMEJOURNAL_H
+#define GAMEJOURNAL_H
+
+#include <QObject>
+#include <QPoint>
+#include <QVector>
+#include "core/GameEngine.h"
+
+class QFile;
+
+// 自动保存日志
+// 文件开头是对局快照（模式和当前落子序列），之后每次落子或悔棋只追加2字节记录并fsync，
+// 程序崩溃或断电最多丢掉正在写的那一条。追加一定数量后把当前局面重新写成快照，
+// 日志长度因此有上限；快照经QSaveFile原子替换，任何时刻磁盘上都是完整可读的文件。
+class GameJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int COMPACT_INTERVAL = 64;
+
+    explicit GameJournal(QObject* parent = nullptr);
+    ~GameJournal();
+
+    void setGameEngine(GameEngine* engine);
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 读取上次没有下完的对局并在引擎中恢复，已分胜负或日志无效时返回false
+    bool restore();
+
+    static QString journalPath();
+
+private slots:
+    void onMoveMade(const QPoint& position, ChessBoard::PieceType piece);
+    void onMoveUndone(const QPoint& position);
+    void onGameStateChanged(GameEngine::GameState state);
+    void onReplayStarted();
+    void onReplayFinished();
+
+private:
+    enum RecordType { MoveRecord = 'M', UndoRecord = 'U' };
+
+    void append(RecordType type, const QPoint& position);
+    bool compact();
+    void close();
+    static bool parse(const QByteArray& data, GameEngine::GameMode* mode, QVector<MoveIndex>* moves);
+
+    GameEngine* m_gameEngine;
+    QFile* m_file;
+    bool m_enabled;
+    bool m_restoring;
+    bool m_replaying;   // 引擎重放期间不逐步追加，结束后写一次快照
+    int m_records;      // 上次压缩后追加的记录数
+};
+
+#endif // GAMEJOURNAL_H
@@ -0,0 +1,431 @@
+#include "GameLibrary.h"
+#include "core/PositionHash.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+GameLibrary* GameLibrary::s_instance = nullptr;
+const int GameLibrary::OPENING_PLIES;
+
+namespace {
+const char LIBRARY_MAGIC[4] = { 'G', 'B', 'L', 'B' };
+const quint32 LIBRARY_VERSION = 1;
+// 记录长度补齐到8字节，映射中的索引项可以直接按结构体读取
+const int RECORD_ALIGNMENT = 8;
+const int MAX_NAME_BYTES = 255;
+
+QByteArray encodeName(const QString& name)
+{
+    QString truncated = name;
+    QByteArray bytes = truncated.toUtf8();
+    while (bytes.size() > MAX_NAME_BYTES) {
+        truncated.chop(1);
+        bytes = truncated.toUtf8();
+    }
+    return bytes;
+}
+
+struct FileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 gameCount;
+    quint32 reserved;
+    quint64 dataEnd;        // 最后一条完整记录之后的文件偏移，追加从这里开始
+    quint64 reserved2;
+};
+
+struct Entry {
+    qint64 timestamp;
+    quint64 openingHash;
+    quint32 recordBytes;    // 整条记录的长度，含索引项、名字、着法和补齐
+    quint8 moveCount;
+    quint8 result;
+    quint8 mode;
+    quint8 blackNameBytes;
+    quint8 whiteNameBytes;
+    quint8 reserved[7];
+};
+
+static_assert(sizeof(FileHeader) == 32, "library header layout changed");
+static_assert(sizeof(Entry) == 32, "library entry layout changed");
+
+const Entry* entryOf(const uchar* record)
+{
+    return reinterpret_cast<const Entry*>(record);
+}
+
+bool syncToDisk(QFile* file)
+{
+    if (!file->flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file->handle()) == 0;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+}
+
+FileHeader makeHeader(quint32 gameCount, quint64 dataEnd)
+{
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LIBRARY_MAGIC, sizeof(header.magic));
+    header.version = qToLittleEndian(LIBRARY_VERSION);
+    header.gameCount = qToLittleEndian(gameCount);
+    header.dataEnd = qToLittleEndian(dataEnd);
+    return header;
+}
+
+// offset处是否是一条完整的记录，limit为可读数据的末尾
+bool isValidRecord(const uchar* map, quint64 offset, quint64 limit)
+{
+    if (offset + sizeof(Entry) > limit) {
+        return false;
+    }
+    const Entry* e = entryOf(map + offset);
+    const quint32 bytes = qFromLittleEndian(e->recordBytes);
+    const quint32 minimum = sizeof(Entry) + e->blackNameBytes + e->whiteNameBytes + e->moveCount;
+    return bytes >= minimum && bytes % RECORD_ALIGNMENT == 0 && offset + bytes <= limit;
+}
+}
+
+GameLibrary* GameLibrary::instance()
+{
+    if (!s_instance) {
+        s_instance = new GameLibrary();
+    }
+    return s_instance;
+}
+
+GameLibrary::GameLibrary(QObject* parent)
+    : QObject(parent)
+    , m_map(nullptr)
+    , m_mapSize(0)
+    , m_dataEnd(0)
+    , m_openingIndexBuilt(false)
+{
+}
+
+GameLibrary::~GameLibrary()
+{
+    close();
+}
+
+bool GameLibrary::open(const QString& path)
+{
+    close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open game library:" << path << m_file.errorString();
+        return false;
+    }
+
+    FileHeader header;
+    if (m_file.size() < static_cast<qint64>(sizeof(FileHeader))) {
+        // 新文件，或者上次连文件头都没写完
+        header = makeHeader(0, sizeof(FileHeader));
+        if (!m_file.resize(0) || m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+            !syncToDisk(&m_file)) {
+            qWarning() << "Failed to initialize game library:" << m_file.errorString();
+            close();
+            return false;
+        }
+    } else if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) {
+        close();
+        return false;
+    }
+
+    if (std::memcmp(header.magic, LIBRARY_MAGIC, sizeof(header.magic)) != 0 ||
+        qFromLittleEndian(header.version) != LIBRARY_VERSION) {
+        qWarning() << "Not a game library file:" << path;
+        close();
+        return false;
+    }
+
+    if (!remap()) {
+        qWarning() << "Failed to map game library:" << path << m_file.errorString();
+        close();
+        return false;
+    }
+
+    const quint64 dataEnd = qFromLittleEndian(header.dataEnd);
+    if (scanRecords(qFromLittleEndian(header.gameCount), dataEnd)) {
+        m_dataEnd = dataEnd;
+    } else if (!recoverRecords()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GameLibrary::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_mapSize = 0;
+    m_dataEnd = 0;
+    m_file.close();
+    m_offsets.clear();
+    m_openingIndex.clear();
+    m_openingIndexBuilt = false;
+}
+
+qint64 GameLibrary::timestamp(int game) const
+{
+    return qFromLittleEndian(entryOf(record(game))->timestamp);
+}
+
+GameLibrary::Result GameLibrary::result(int game) const
+{
+    return static_cast<Result>(entryOf(record(game))->result);
+}
+
+int GameLibrary::moveCount(int game) const
+{
+    return entryOf(record(game))->moveCount;
+}
+
+quint64 GameLibrary::openingHash(int game) const
+{
+    return qFromLittleEndian(entryOf(record(game))->openingHash);
+}
+
+QString GameLibrary::blackName(int game) const
+{
+    const Entry* e = entryOf(record(game));
+    return QString::fromUtf8(reinterpret_cast<const char*>(record(game)) + sizeof(Entry), e->blackNameBytes);
+}
+
+QString GameLibrary::whiteName(int game) const
+{
+    const Entry* e = entryOf(record(game));
+    return QString::fromUtf8(reinterpret_cast<const char*>(record(game)) + sizeof(Entry) + e->blackNameBytes,
+                             e->whiteNameBytes);
+}
+
+GameLibrary::GameInfo GameLibrary::info(int game) const
+{
+    GameInfo info;
+    info.timestamp = timestamp(game);
+    info.blackName = blackName(game);
+    info.whiteName = whiteName(game);
+    info.result = result(game);
+    info.mode = static_cast<GameEngine::GameMode>(entryOf(record(game))->mode);
+    info.moveCount = moveCount(game);
+    info.openingHash = openingHash(game);
+    return info;
+}
+
+QVector<MoveIndex> GameLibrary::moves(int game) const
+{
+    const Entry* e = entryOf(record(game));
+    const uchar* data = record(game) + sizeof(Entry) + e->blackNameBytes + e->whiteNameBytes;
+
+    QVector<MoveIndex> moves;
+    moves.reserve(e->moveCount);
+    for (int i = 0; i < e->moveCount; ++i) {
+        moves.append(MoveIndex(data[i]));
+    }
+    return moves;
+}
+
+int GameLibrary::addGame(const GameInfo& info, const QVector<MoveIndex>& moves)
+{
+    if ((!isOpen() && !open()) || moves.size() > MoveIndex::CELL_COUNT) {
+        return -1;
+    }
+
+    const QByteArray black = encodeName(info.blackName);
+    const QByteArray white = encodeName(info.whiteName);
+    const int unpadded = static_cast<int>(sizeof(Entry)) + black.size() + white.size() + moves.size();
+    const int bytes = (unpadded + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    if (m_dataEnd + bytes > 0xFFFFFFFFull) {
+        qWarning() << "Game library is full:" << path();
+        return -1;
+    }
+
+    const quint64 hash = computeOpeningHash(moves);
+    Entry e;
+    std::memset(&e, 0, sizeof(e));
+    e.timestamp = qToLittleEndian(info.timestamp);
+    e.openingHash = qToLittleEndian(hash);
+    e.recordBytes = qToLittleEndian(static_cast<quint32>(bytes));
+    e.moveCount = static_cast<quint8>(moves.size());
+    e.result = static_cast<quint8>(info.result);
+    e.mode = static_cast<quint8>(info.mode);
+    e.blackNameBytes = static_cast<quint8>(black.size());
+    e.whiteNameBytes = static_cast<quint8>(white.size());
+
+    QByteArray data(bytes, '\0');
+    char* out = data.data();
+    std::memcpy(out, &e, sizeof(e));
+    out += sizeof(e);
+    std::memcpy(out, black.constData(), black.size());
+    out += black.size();
+    std::memcpy(out, white.constData(), white.size());
+    out += white.size();
+    for (MoveIndex move : moves) {
+        *out++ = static_cast<char>(move.value());
+    }
+
+    // 记录先落盘，再更新文件头，文件头里的局数和末尾偏移就是提交点；
+    // 两次fsync保证磁盘上不会出现文件头已更新而记录还没写到的情况
+    const FileHeader header = makeHeader(static_cast<quint32>(m_offsets.size() + 1), m_dataEnd + bytes);
+    if (!m_file.seek(static_cast<qint64>(m_dataEnd)) || m_file.write(data) != bytes || !syncToDisk(&m_file) ||
+        !m_file.seek(0) || m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+        !syncToDisk(&m_file)) {
+        qWarning() << "Failed to append to game library:" << m_file.errorString();
+        return -1;
+    }
+
+    const int game = m_offsets.size();
+    m_offsets.append(static_cast<quint32>(m_dataEnd));
+    m_dataEnd += bytes;
+    if (!remap()) {
+        qWarning() << "Failed to map game library:" << m_file.errorString();
+        close();
+        return -1;
+    }
+    if (m_openingIndexBuilt) {
+        m_openingIndex[hash].append(game);
+    }
+
+    emit gameAdded(game);
+    return game;
+}
+
+int GameLibrary::addGame(const GameEngine* engine)
+{
+    const ChessBoard* board = engine->chessBoard();
+
+    GameInfo info;
+    info.timestamp = QDateTime::currentMSecsSinceEpoch();
+    info.blackName = engine->player(0) ? engine->player(0)->name() : QString("黑方");
+    info.whiteName = engine->player(1) ? engine->player(1)->name() : QString("白方");
+    info.mode = engine->gameMode();
+    if (engine->winner() == ChessBoard::Black) {
+        info.result = BlackWins;
+    } else if (engine->winner() == ChessBoard::White) {
+        info.result = WhiteWins;
+    } else if (engine->isGameFinished() && engine->gameRule()->isDraw(board)) {
+        info.result = Draw;
+    }
+
+    QVector<MoveIndex> moves;
+    moves.reserve(board->moveCount());
+    for (MoveIndex move : board->history()) {
+        moves.append(move);
+    }
+    return addGame(info, moves);
+}
+
+QVector<int> GameLibrary::gamesWithOpening(quint64 hash) const
+{
+    if (!m_openingIndexBuilt) {
+        m_openingIndex.reserve(gameCount());
+        for (int game = 0; game < gameCount(); ++game) {
+            m_openingIndex[openingHash(game)].append(game);
+        }
+        m_openingIndexBuilt = true;
+    }
+    return m_openingIndex.value(hash);
+}
+
+quint64 GameLibrary::computeOpeningHash(const QVector<MoveIndex>& moves)
+{
+    PositionHash hash;
+    const int plies = qMin(moves.size(), static_cast<int>(OPENING_PLIES));
+    for (int ply = 0; ply < plies; ++ply) {
+        hash.toggle(moves[ply], ply % 2 == 0 ? ChessBoard::Black : ChessBoard::White);
+    }
+    return hash.canonical();
+}
+
+QString GameLibrary::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/library.gbl";
+}
+
+bool GameLibrary::remap()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    // 文件追加后变长，重新映射整个文件；只是建立虚拟内存映射，不读取内容
+    m_mapSize = m_file.size();
+    m_map = m_file.map(0, m_mapSize);
+    return m_map != nullptr;
+}
+
+bool GameLibrary::scanRecords(quint32 gameCount, quint64 dataEnd)
+{
+    m_offsets.clear();
+    if (dataEnd < sizeof(FileHeader) || dataEnd > static_cast<quint64>(m_mapSize) || dataEnd > 0xFFFFFFFFull) {
+        return false;
+    }
+
+    // 只沿记录长度跳跃，不解码名字和着法
+    m_offsets.reserve(static_cast<int>(gameCount));
+    quint64 offset = sizeof(FileHeader);
+    for (quint32 i = 0; i < gameCount; ++i) {
+        if (!isValidRecord(m_map, offset, dataEnd)) {
+            return false;
+        }
+        m_offsets.append(static_cast<quint32>(offset));
+        offset += qFromLittleEndian(entryOf(m_map + offset)->recordBytes);
+    }
+    return offset == dataEnd;
+}
+
+bool GameLibrary::recoverRecords()
+{
+    // 文件头与记录对不上（写文件头时断电，或磁盘没有按顺序落盘）：
+    // 从头沿记录长度走到文件末尾，保留全部完整的记录，再写回正确的文件头
+    m_offsets.clear();
+    const quint64 limit = qMin<quint64>(static_cast<quint64>(m_mapSize), 0xFFFFFFFFull);
+    quint64 offset = sizeof(FileHeader);
+    while (isValidRecord(m_map, offset, limit) && !hasInvalidMoves(offset)) {
+        m_offsets.append(static_cast<quint32>(offset));
+        offset += qFromLittleEndian(entryOf(m_map + offset)->recordBytes);
+    }
+
+    const FileHeader header = makeHeader(static_cast<quint32>(m_offsets.size()), offset);
+    if (!m_file.seek(0) || m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+        !syncToDisk(&m_file)) {
+        qWarning() << "Failed to repair game library header:" << path() << m_file.errorString();
+        return false;
+    }
+
+    qWarning() << "Game library header was inconsistent, recovered" << m_offsets.size() << "games:" << path();
+    m_dataEnd = offset;
+    return true;
+}
+
+bool GameLibrary::hasInvalidMoves(quint64 offset) const
+{
+    const Entry* e = entryOf(m_map + offset);
+    const uchar* moves = m_map + offset + sizeof(Entry) + e->blackNameBytes + e->whiteNameBytes;
+    for (int i = 0; i < e->moveCount; ++i) {
+        if (moves[i] >= MoveIndex::CELL_COUNT) {
+            return true;
+        }
+    }
+    return e->result > Draw;
+}
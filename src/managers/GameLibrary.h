@@ -0,0 +1,98 @@
+#ifndef GAMELIBRARY_H
+#define GAMELIBRARY_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include "core/GameEngine.h"
+#include "core/MoveIndex.h"
+
+// 棋谱库
+// 全部对局存放在一个文件里：32字节文件头之后依次是各局的记录，每条记录由32字节的定长索引项
+// （日期、结果、模式、开局哈希、步数、名字长度）、双方名字和每步1字节的着法组成。
+// 打开时整个文件映射进内存，只沿记录长度跳一遍建立偏移表，列表显示、排序和筛选都直接读映射中的索引项，
+// 着法只在真正打开某一局时才解码。新对局追加在末尾，记录fsync之后才更新文件头里的局数并再次fsync，
+// 中途崩溃留下的半条记录不会被读到，下次追加时被覆盖。文件头若与记录对不上（例如文件头写到一半），
+// 打开时沿记录长度扫描到文件末尾，保留所有完整的记录并重写文件头，而不是整个库拒绝打开。
+class GameLibrary : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Result { Unfinished = 0, BlackWins = 1, WhiteWins = 2, Draw = 3 };
+
+    // 开局哈希取前几手之后局面的规范哈希，对称的开局归为一类
+    static const int OPENING_PLIES = 6;
+
+    struct GameInfo {
+        qint64 timestamp;             // 对局保存时间，UTC毫秒
+        QString blackName;
+        QString whiteName;
+        Result result;
+        GameEngine::GameMode mode;
+        int moveCount;
+        quint64 openingHash;
+
+        GameInfo() : timestamp(0), result(Unfinished), mode(GameEngine::PvP), moveCount(0), openingHash(0) {}
+    };
+
+    static GameLibrary* instance();
+    ~GameLibrary();
+
+    // 打开或新建棋谱库文件，之前打开的文件会先关闭
+    bool open(const QString& path = defaultPath());
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString path() const { return m_file.fileName(); }
+
+    int gameCount() const { return m_offsets.size(); }
+
+    // 以下只读取索引项，不解码着法，game为0到gameCount()-1
+    qint64 timestamp(int game) const;
+    Result result(int game) const;
+    int moveCount(int game) const;
+    quint64 openingHash(int game) const;
+    QString blackName(int game) const;
+    QString whiteName(int game) const;
+    GameInfo info(int game) const;
+
+    // 解码一局的全部着法
+    QVector<MoveIndex> moves(int game) const;
+
+    // 追加一局并返回编号，失败返回-1；info中的步数和开局哈希按moves重新计算
+    int addGame(const GameInfo& info, const QVector<MoveIndex>& moves);
+    // 保存引擎中的对局：当前局面为止的着法、双方名字和结果
+    int addGame(const GameEngine* engine);
+
+    // 与某局同一开局的全部对局，索引在第一次查询时建立，之后随追加维护
+    QVector<int> gamesWithOpening(quint64 hash) const;
+
+    static quint64 computeOpeningHash(const QVector<MoveIndex>& moves);
+    static QString defaultPath();
+
+signals:
+    void gameAdded(int game);
+
+private:
+    explicit GameLibrary(QObject* parent = nullptr);
+
+    bool remap();
+    bool scanRecords(quint32 gameCount, quint64 dataEnd);
+    bool recoverRecords();
+    bool hasInvalidMoves(quint64 offset) const;
+    const uchar* record(int game) const { return m_map + m_offsets[game]; }
+
+    QFile m_file;
+    uchar* m_map;
+    qint64 m_mapSize;
+    quint64 m_dataEnd;
+    QVector<quint32> m_offsets;
+    mutable QHash<quint64, QVector<int>> m_openingIndex;
+    mutable bool m_openingIndexBuilt;
+
+    static GameLibrary* s_instance;
+};
+
+#endif // GAMELIBRARY_H
@@ -0,0 +1,422 @@
+#include "PositionIndex.h"
+#include "GameLibrary.h"
+#include "core/PositionHash.h"
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+PositionIndex* PositionIndex::s_instance = nullptr;
+const int PositionIndex::PATTERN_RADIUS;
+const int PositionIndex::MERGE_INTERVAL;
+
+namespace {
+const char INDEX_MAGIC[4] = { 'G', 'B', 'I', 'X' };
+const quint32 INDEX_VERSION = 1;
+// 局部棋形中超出棋盘的格子按第三种“颜色”计入，贴边的棋形与棋盘中央的不混为一类
+const int EDGE_PIECE = 3;
+const int WRITE_CHUNK = 4096;
+
+struct IndexHeader {
+    char magic[4];
+    quint32 version;
+    quint32 gameCount;          // 覆盖的局数，即棋谱库中编号0到gameCount-1的对局
+    quint32 entryCount;
+    qint64 lastTimestamp;       // 最后一局的保存时间和开局哈希，棋谱库被替换时据此发现索引已过期
+    quint64 lastOpeningHash;
+};
+
+struct Entry {
+    quint64 key;
+    quint32 game;
+    quint8 ply;
+    quint8 kind;
+    quint16 reserved;
+};
+
+static_assert(sizeof(IndexHeader) == 32, "index header layout changed");
+static_assert(sizeof(Entry) == 16, "index entry layout changed");
+
+// 文件中按小端存放，以下比较和写入都针对主机字节序的Entry
+Entry fromDisk(const Entry& e)
+{
+    Entry host = e;
+    host.key = qFromLittleEndian(e.key);
+    host.game = qFromLittleEndian(e.game);
+    return host;
+}
+
+Entry toDisk(const Entry& e)
+{
+    Entry disk = e;
+    disk.key = qToLittleEndian(e.key);
+    disk.game = qToLittleEndian(e.game);
+    return disk;
+}
+
+bool entryLess(const Entry& a, const Entry& b)
+{
+    if (a.kind != b.kind) {
+        return a.kind < b.kind;
+    }
+    if (a.key != b.key) {
+        return a.key < b.key;
+    }
+    if (a.game != b.game) {
+        return a.game < b.game;
+    }
+    return a.ply < b.ply;
+}
+
+// 以center为中心的(2R+1)x(2R+1)窗口，棋子坐标取相对中心的偏移，8种对称下取最小哈希
+template <typename PieceAt>
+quint64 computePatternHash(PieceAt pieceAt, MoveIndex center)
+{
+    const int radius = PositionIndex::PATTERN_RADIUS;
+    const int size = 2 * radius + 1;
+    quint64 hashes[PositionHash::SYMMETRIES] = {};
+
+    for (int dr = -radius; dr <= radius; ++dr) {
+        for (int dc = -radius; dc <= radius; ++dc) {
+            const int row = center.row() + dr;
+            const int col = center.col() + dc;
+            const bool onBoard = row >= 0 && row < MoveIndex::BOARD_SIZE && col >= 0 && col < MoveIndex::BOARD_SIZE;
+            const int piece = onBoard ? pieceAt(row, col) : EDGE_PIECE;
+            if (piece == ChessBoard::Empty) {
+                continue;
+            }
+
+            for (int symmetry = 0; symmetry < PositionHash::SYMMETRIES; ++symmetry) {
+                int r = (symmetry & 2) ? -dr : dr;
+                int c = (symmetry & 1) ? -dc : dc;
+                if (symmetry & 4) {
+                    std::swap(r, c);
+                }
+                const MoveIndex offset(static_cast<quint8>((r + radius) * size + (c + radius)));
+                hashes[symmetry] ^= PositionHash::key(offset, piece);
+            }
+        }
+    }
+    return *std::min_element(hashes, hashes + PositionHash::SYMMETRIES);
+}
+}
+
+PositionIndex* PositionIndex::instance()
+{
+    if (!s_instance) {
+        s_instance = new PositionIndex();
+    }
+    return s_instance;
+}
+
+PositionIndex::PositionIndex(QObject* parent)
+    : QObject(parent)
+    , m_library(GameLibrary::instance())
+    , m_map(nullptr)
+    , m_entryCount(0)
+    , m_fileGames(0)
+    , m_pendingGames(0)
+{
+    connect(m_library, &GameLibrary::gameAdded, this, &PositionIndex::onGameAdded);
+}
+
+PositionIndex::~PositionIndex()
+{
+    unload();
+}
+
+QVector<PositionIndex::Occurrence> PositionIndex::findPosition(quint64 canonicalHash)
+{
+    return find(PositionKey, canonicalHash);
+}
+
+QVector<PositionIndex::Occurrence> PositionIndex::findPattern(quint64 patternHash)
+{
+    return find(PatternKey, patternHash);
+}
+
+QVector<PositionIndex::Occurrence> PositionIndex::findPosition(const ChessBoard* board)
+{
+    if (board->moveCount() == 0) {
+        return QVector<Occurrence>();
+    }
+    return find(PositionKey, positionHash(board));
+}
+
+QVector<PositionIndex::Occurrence> PositionIndex::findPattern(const ChessBoard* board, MoveIndex center)
+{
+    if (!center.isValid() || board->pieceAt(center.row(), center.col()) == ChessBoard::Empty) {
+        return QVector<Occurrence>();
+    }
+    return find(PatternKey, patternHash(board, center));
+}
+
+int PositionIndex::findGame(const ChessBoard* board)
+{
+    // 同一序列必然在最后一手到达同一局面，只需逐一比对这些候选的着法
+    const ChessBoard::HistoryView history = board->history();
+    for (const Occurrence& occurrence : findPosition(board)) {
+        if (occurrence.ply != history.size() || m_library->moveCount(occurrence.game) != history.size()) {
+            continue;
+        }
+        const QVector<MoveIndex> moves = m_library->moves(occurrence.game);
+        if (std::equal(moves.constBegin(), moves.constEnd(), history.begin())) {
+            return occurrence.game;
+        }
+    }
+    return -1;
+}
+
+quint64 PositionIndex::positionHash(const ChessBoard* board)
+{
+    PositionHash hash;
+    for (MoveIndex move : board->history()) {
+        hash.toggle(move, board->pieceAt(move.row(), move.col()));
+    }
+    return hash.canonical();
+}
+
+quint64 PositionIndex::patternHash(const ChessBoard* board, MoveIndex center)
+{
+    return computePatternHash([board](int row, int col) { return static_cast<int>(board->pieceAt(row, col)); },
+                              center);
+}
+
+QString PositionIndex::indexPath(const QString& libraryPath)
+{
+    const QFileInfo info(libraryPath);
+    return info.absolutePath() + "/" + info.completeBaseName() + ".gbi";
+}
+
+void PositionIndex::onGameAdded(int game)
+{
+    // 新保存的对局立即进入增量表，下一次查询就能找到
+    Q_UNUSED(game)
+    sync();
+}
+
+bool PositionIndex::sync()
+{
+    if (!m_library->isOpen() && !m_library->open()) {
+        unload();
+        m_libraryPath.clear();
+        return false;
+    }
+
+    if (m_libraryPath != m_library->path()) {
+        unload();
+        m_libraryPath = m_library->path();
+        load();
+    }
+
+    // 棋谱库比索引覆盖的局数还少，说明文件被换掉了，整个重建
+    if (m_fileGames + m_pendingGames > m_library->gameCount()) {
+        unload();
+    }
+
+    indexNewGames();
+    if (m_pendingGames >= MERGE_INTERVAL && !flush()) {
+        // 没有写成，文件仍是旧的，未覆盖的对局重新补进增量表
+        indexNewGames();
+    }
+    return true;
+}
+
+bool PositionIndex::load()
+{
+    m_file.setFileName(indexPath(m_libraryPath));
+    if (!m_file.exists()) {
+        return true;
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open position index:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    IndexHeader header;
+    bool valid = m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) == sizeof(header) &&
+                 std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                 qFromLittleEndian(header.version) == INDEX_VERSION;
+
+    const quint32 gameCount = valid ? qFromLittleEndian(header.gameCount) : 0;
+    const quint32 entryCount = valid ? qFromLittleEndian(header.entryCount) : 0;
+    valid = valid &&
+            m_file.size() == static_cast<qint64>(sizeof(IndexHeader) + static_cast<quint64>(entryCount) * sizeof(Entry)) &&
+            gameCount <= static_cast<quint32>(m_library->gameCount());
+    if (valid && gameCount > 0) {
+        const int last = static_cast<int>(gameCount) - 1;
+        valid = m_library->timestamp(last) == qFromLittleEndian(header.lastTimestamp) &&
+                m_library->openingHash(last) == qFromLittleEndian(header.lastOpeningHash);
+    }
+    if (valid && entryCount > 0) {
+        m_map = m_file.map(0, m_file.size());
+        valid = m_map != nullptr;
+    }
+
+    if (!valid) {
+        // 过期或损坏的索引不再使用，由sync从棋谱库重建
+        qWarning() << "Position index is stale, rebuilding:" << m_file.fileName();
+        unload();
+        return false;
+    }
+
+    m_entryCount = entryCount;
+    m_fileGames = static_cast<int>(gameCount);
+    return true;
+}
+
+void PositionIndex::unload()
+{
+    if (m_map) {
+        m_file.unmap(const_cast<uchar*>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_entryCount = 0;
+    m_fileGames = 0;
+    m_pendingGames = 0;
+    for (int kind = 0; kind < KindCount; ++kind) {
+        m_pending[kind].clear();
+    }
+}
+
+void PositionIndex::indexNewGames()
+{
+    for (int game = m_fileGames + m_pendingGames; game < m_library->gameCount(); ++game) {
+        indexGame(game);
+    }
+}
+
+void PositionIndex::indexGame(int game)
+{
+    const QVector<MoveIndex> moves = m_library->moves(game);
+    int cells[MoveIndex::CELL_COUNT] = {};
+    auto pieceAt = [&cells](int row, int col) { return cells[row * MoveIndex::BOARD_SIZE + col]; };
+
+    PositionHash position;
+    for (int ply = 0; ply < moves.size(); ++ply) {
+        const MoveIndex move = moves[ply];
+        if (!move.isValid() || cells[move.value()] != ChessBoard::Empty) {
+            break;
+        }
+
+        const int piece = (ply % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+        cells[move.value()] = piece;
+        position.toggle(move, piece);
+
+        const Occurrence occurrence = { game, ply + 1 };
+        m_pending[PositionKey][position.canonical()].append(occurrence);
+        m_pending[PatternKey][computePatternHash(pieceAt, move)].append(occurrence);
+    }
+    ++m_pendingGames;
+}
+
+QVector<PositionIndex::Occurrence> PositionIndex::find(Kind kind, quint64 key)
+{
+    QVector<Occurrence> result;
+    if (!sync()) {
+        return result;
+    }
+
+    if (m_map) {
+        const Entry* begin = reinterpret_cast<const Entry*>(m_map + sizeof(IndexHeader));
+        const Entry* end = begin + m_entryCount;
+        Entry target;
+        std::memset(&target, 0, sizeof(target));
+        target.kind = static_cast<quint8>(kind);
+        target.key = key;
+
+        const Entry* it = std::lower_bound(begin, end, target, [](const Entry& e, const Entry& value) {
+            return entryLess(fromDisk(e), value);
+        });
+        for (; it != end; ++it) {
+            const Entry e = fromDisk(*it);
+            if (e.kind != kind || e.key != key) {
+                break;
+            }
+            const Occurrence occurrence = { static_cast<int>(e.game), e.ply };
+            result.append(occurrence);
+        }
+    }
+
+    // 增量表中的对局编号都大于文件覆盖的局，直接接在后面仍然有序
+    result += m_pending[kind].value(key);
+    return result;
+}
+
+bool PositionIndex::flush()
+{
+    if (m_pendingGames == 0 || m_libraryPath.isEmpty()) {
+        return true;
+    }
+
+    std::vector<Entry> added;
+    for (int kind = 0; kind < KindCount; ++kind) {
+        for (auto it = m_pending[kind].constBegin(); it != m_pending[kind].constEnd(); ++it) {
+            for (const Occurrence& occurrence : it.value()) {
+                Entry e;
+                std::memset(&e, 0, sizeof(e));
+                e.key = it.key();
+                e.game = static_cast<quint32>(occurrence.game);
+                e.ply = static_cast<quint8>(occurrence.ply);
+                e.kind = static_cast<quint8>(kind);
+                added.push_back(e);
+            }
+        }
+    }
+    std::sort(added.begin(), added.end(), entryLess);
+
+    const int gameCount = m_fileGames + m_pendingGames;
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = qToLittleEndian(INDEX_VERSION);
+    header.gameCount = qToLittleEndian(static_cast<quint32>(gameCount));
+    header.entryCount = qToLittleEndian(static_cast<quint32>(m_entryCount + added.size()));
+    header.lastTimestamp = qToLittleEndian(m_library->timestamp(gameCount - 1));
+    header.lastOpeningHash = qToLittleEndian(m_library->openingHash(gameCount - 1));
+
+    QSaveFile file(indexPath(m_libraryPath));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write position index:" << file.fileName() << file.errorString();
+        return false;
+    }
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+
+    // 已排序的文件项与增量项归并，分块写出
+    const Entry* fileEntries = m_map ? reinterpret_cast<const Entry*>(m_map + sizeof(IndexHeader)) : nullptr;
+    quint32 i = 0;
+    size_t j = 0;
+    std::vector<Entry> chunk;
+    chunk.reserve(WRITE_CHUNK);
+    while (ok && (i < m_entryCount || j < added.size())) {
+        if (j == added.size() || (i < m_entryCount && entryLess(fromDisk(fileEntries[i]), added[j]))) {
+            chunk.push_back(fileEntries[i++]);
+        } else {
+            chunk.push_back(toDisk(added[j++]));
+        }
+        if (chunk.size() == WRITE_CHUNK || (i == m_entryCount && j == added.size())) {
+            const qint64 bytes = static_cast<qint64>(chunk.size() * sizeof(Entry));
+            ok = file.write(reinterpret_cast<const char*>(chunk.data()), bytes) == bytes;
+            chunk.clear();
+        }
+    }
+    if (!ok) {
+        qWarning() << "Failed to write position index:" << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    // Windows上被映射的文件不能被替换，提交前先解除映射；无论成败都重新加载，
+    // 没有写进文件的对局由下一次sync补回增量表
+    unload();
+    const bool committed = file.commit();
+    if (!committed) {
+        qWarning() << "Failed to replace position index:" << file.fileName() << file.errorString();
+    }
+    load();
+    return committed;
+}
@@ -0,0 +1,79 @@
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include "core/ChessBoard.h"
+#include "core/MoveIndex.h"
+
+class GameLibrary;
+
+// 棋谱库的局面倒排索引
+// 对每局的每一手记录两类键：落子后整盘局面的规范哈希，以及以这手为中心的5x5局部棋形的规范哈希，
+// 两者都在8种对称变换下取最小值。键映射到(对局, 手数)，查询只是一次二分查找和一次散列查找。
+// 索引文件与棋谱库放在一起，按(类型, 键, 对局, 手数)排序后整体映射进内存；
+// 之后保存的对局先进入内存中的增量表，攒够一定局数再与文件归并，经QSaveFile原子替换。
+// 文件头记录已覆盖的局数，棋谱库里更新的对局在下次打开时补进增量表。
+class PositionIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int PATTERN_RADIUS = 2;
+    static const int MERGE_INTERVAL = 256;
+
+    struct Occurrence {
+        int game;
+        int ply;        // 第几手之后到达，从1开始
+    };
+
+    static PositionIndex* instance();
+    ~PositionIndex();
+
+    // 查询前自动打开棋谱库和索引；结果按对局编号、手数升序
+    QVector<Occurrence> findPosition(quint64 canonicalHash);
+    QVector<Occurrence> findPattern(quint64 patternHash);
+    QVector<Occurrence> findPosition(const ChessBoard* board);
+    QVector<Occurrence> findPattern(const ChessBoard* board, MoveIndex center);
+
+    // 棋谱库中着法序列与board的落子历史完全相同的一局，没有时返回-1
+    int findGame(const ChessBoard* board);
+
+    // 把增量表归并进索引文件
+    bool flush();
+
+    static quint64 positionHash(const ChessBoard* board);
+    static quint64 patternHash(const ChessBoard* board, MoveIndex center);
+    static QString indexPath(const QString& libraryPath);
+
+private slots:
+    void onGameAdded(int game);
+
+private:
+    enum Kind { PositionKey = 0, PatternKey = 1, KindCount };
+
+    explicit PositionIndex(QObject* parent = nullptr);
+
+    bool sync();
+    bool load();
+    void unload();
+    void indexNewGames();
+    void indexGame(int game);
+    QVector<Occurrence> find(Kind kind, quint64 key);
+
+    GameLibrary* m_library;
+    QString m_libraryPath;  // 当前索引对应的棋谱库
+    QFile m_file;
+    const uchar* m_map;
+    quint32 m_entryCount;
+    int m_fileGames;        // 索引文件已覆盖的局数
+    int m_pendingGames;     // 增量表中的局数，紧接在文件覆盖的局之后
+    QHash<quint64, QVector<Occurrence>> m_pending[KindCount];
+
+    static PositionIndex* s_instance;
+};
+
+#endif // POSITIONINDEX_H
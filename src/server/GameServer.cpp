@@ -0,0 +1,394 @@
+#include "GameServer.h"
+#include "ai/MinimaxSearch.h"
+#include <QHostAddress>
+#include <QDebug>
+#include <memory>
+
+GameServer::GameServer(int maxSessions, int workerCount, QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_scheduler(new AIScheduler(workerCount, this))
+    , m_sessions(maxSessions)
+    , m_pendingAI(0)
+{
+    connect(m_server, &QTcpServer::newConnection,
+            this, &GameServer::onNewConnection);
+}
+
+GameServer::~GameServer()
+{
+    m_server->close();
+
+    // 先等待工作线程结束，它们会向本对象投递结果
+    delete m_scheduler;
+    m_scheduler = nullptr;
+}
+
+bool GameServer::listen(quint16 port)
+{
+    return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+void GameServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket* socket = m_server->nextPendingConnection();
+        m_clients.insert(socket, ClientState());
+
+        connect(socket, &QTcpSocket::readyRead, this, &GameServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &GameServer::onDisconnected);
+    }
+}
+
+void GameServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_clients.contains(socket)) {
+        return;
+    }
+
+    ClientState& client = m_clients[socket];
+    client.buffer.append(socket->readAll());
+
+    int newline;
+    while ((newline = client.buffer.indexOf('\n')) >= 0) {
+        QByteArray line = client.buffer.left(newline).trimmed();
+        client.buffer.remove(0, newline + 1);
+        if (!line.isEmpty()) {
+            handleLine(socket, line);
+        }
+        // QUIT可能已经断开连接
+        if (!m_clients.contains(socket)) {
+            return;
+        }
+    }
+
+    // 防止恶意客户端发送超长行
+    if (m_clients[socket].buffer.size() > MAX_LINE_LENGTH) {
+        sendLine(socket, "ERR line too long");
+        socket->disconnectFromHost();
+    }
+}
+
+void GameServer::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    auto it = m_clients.find(socket);
+    if (it != m_clients.end()) {
+        for (quint32 handle : it->sessions) {
+            cancelAIMove(handle);
+            m_sessions.release(handle);
+        }
+        m_clients.erase(it);
+    }
+
+    socket->deleteLater();
+}
+
+void GameServer::handleLine(QTcpSocket* socket, const QByteArray& line)
+{
+    QList<QByteArray> args = line.simplified().split(' ');
+    QByteArray command = args.takeFirst().toUpper();
+
+    if (command == "NEW") {
+        handleNew(socket, args);
+    } else if (command == "MOVE") {
+        handleMove(socket, args);
+    } else if (command == "UNDO") {
+        handleUndo(socket, args);
+    } else if (command == "BOARD") {
+        handleBoard(socket, args);
+    } else if (command == "CLOSE") {
+        handleClose(socket, args);
+    } else if (command == "STATS") {
+        handleStats(socket);
+    } else if (command == "QUIT") {
+        socket->disconnectFromHost();
+    } else {
+        sendLine(socket, "ERR unknown command");
+    }
+}
+
+void GameServer::handleNew(QTcpSocket* socket, const QList<QByteArray>& args)
+{
+    GameSession::Mode mode = GameSession::PvP;
+    if (!args.isEmpty()) {
+        QByteArray modeArg = args[0].toLower();
+        if (modeArg == "pvc") {
+            mode = GameSession::PvC;
+        } else if (modeArg != "pvp") {
+            sendLine(socket, "ERR bad mode");
+            return;
+        }
+    }
+
+    int difficulty = 2;
+    if (args.size() > 1) {
+        bool ok = false;
+        difficulty = args[1].toInt(&ok);
+        if (!ok) {
+            sendLine(socket, "ERR bad difficulty");
+            return;
+        }
+    }
+
+    quint32 handle = m_sessions.allocate();
+    GameSession* session = m_sessions.get(handle);
+    if (!session) {
+        sendLine(socket, "ERR server full");
+        return;
+    }
+
+    session->reset(mode, difficulty, socket);
+    m_clients[socket].sessions.append(handle);
+    sendLine(socket, "OK " + QByteArray::number(handle));
+}
+
+void GameServer::handleMove(QTcpSocket* socket, const QList<QByteArray>& args)
+{
+    if (args.size() < 3) {
+        sendLine(socket, "ERR usage: MOVE <sid> <x> <y>");
+        return;
+    }
+
+    quint32 handle;
+    GameSession* session = ownedSession(socket, args[0], &handle);
+    if (!session) {
+        return;
+    }
+
+    if (session->aiPending || (session->mode == GameSession::PvC &&
+                               session->currentPlayer() == ChessBoard::White)) {
+        sendLine(socket, "ERR not your turn");
+        return;
+    }
+
+    // 人机对局在落子前做准入检查，避免AI队列无限增长
+    if (session->mode == GameSession::PvC && !m_scheduler->canAdmit(AIScheduler::Interactive)) {
+        sendLine(socket, "ERR busy");
+        return;
+    }
+
+    bool okX = false;
+    bool okY = false;
+    int x = args[1].toInt(&okX);
+    int y = args[2].toInt(&okY);
+    if (!okX || !okY || !session->play(y, x)) {
+        sendLine(socket, "ERR illegal move");
+        return;
+    }
+
+    // 调度器在准入检查之后仍可能拒绝请求，此时撤回这步棋，局面保持轮到人类落子
+    if (session->mode == GameSession::PvC && session->state != GameSession::Finished &&
+        !requestAIMove(handle, session)) {
+        session->undo();
+        sendLine(socket, "ERR busy");
+        return;
+    }
+
+    // AI的结果经事件队列投递回来，一定在这条确认之后发出
+    sendLine(socket, "OK " + args[0] + ' ' + QByteArray::number(x) + ' ' + QByteArray::number(y));
+
+    if (session->state == GameSession::Finished) {
+        notifyGameEnd(socket, handle, session);
+    }
+}
+
+void GameServer::handleUndo(QTcpSocket* socket, const QList<QByteArray>& args)
+{
+    if (args.isEmpty()) {
+        sendLine(socket, "ERR usage: UNDO <sid>");
+        return;
+    }
+
+    quint32 handle;
+    GameSession* session = ownedSession(socket, args[0], &handle);
+    if (!session) {
+        return;
+    }
+
+    if (session->aiPending || !session->undo()) {
+        sendLine(socket, "ERR cannot undo");
+        return;
+    }
+
+    // 人机对战同时撤销AI的一步，保持轮到人类落子
+    if (session->mode == GameSession::PvC && session->currentPlayer() == ChessBoard::White) {
+        session->undo();
+    }
+
+    sendLine(socket, "OK " + args[0]);
+}
+
+void GameServer::handleBoard(QTcpSocket* socket, const QList<QByteArray>& args)
+{
+    if (args.isEmpty()) {
+        sendLine(socket, "ERR usage: BOARD <sid>");
+        return;
+    }
+
+    quint32 handle;
+    GameSession* session = ownedSession(socket, args[0], &handle);
+    if (!session) {
+        return;
+    }
+
+    static const char SYMBOLS[3] = { '.', 'X', 'O' };
+    QByteArray cells(GameSession::CELL_COUNT, '.');
+    for (int i = 0; i < GameSession::CELL_COUNT; ++i) {
+        cells[i] = SYMBOLS[session->cells[i]];
+    }
+    sendLine(socket, "BOARD " + args[0] + ' ' + cells);
+}
+
+void GameServer::handleClose(QTcpSocket* socket, const QList<QByteArray>& args)
+{
+    if (args.isEmpty()) {
+        sendLine(socket, "ERR usage: CLOSE <sid>");
+        return;
+    }
+
+    quint32 handle;
+    if (!ownedSession(socket, args[0], &handle)) {
+        return;
+    }
+
+    closeSession(socket, handle);
+    sendLine(socket, "OK " + args[0]);
+}
+
+void GameServer::handleStats(QTcpSocket* socket)
+{
+    sendLine(socket, QByteArray("STATS sessions=") + QByteArray::number(m_sessions.size())
+             + " pending=" + QByteArray::number(m_pendingAI)
+             + " queued=" + QByteArray::number(m_scheduler->queuedCount())
+             + " workers=" + QByteArray::number(m_scheduler->workerCount()));
+}
+
+GameSession* GameServer::ownedSession(QTcpSocket* socket, const QByteArray& arg, quint32* handle)
+{
+    bool ok = false;
+    *handle = arg.toUInt(&ok);
+    GameSession* session = ok ? m_sessions.get(*handle) : nullptr;
+
+    if (!session || session->state == GameSession::Free || session->owner != socket) {
+        sendLine(socket, "ERR no such session");
+        return nullptr;
+    }
+    return session;
+}
+
+void GameServer::closeSession(QTcpSocket* socket, quint32 handle)
+{
+    cancelAIMove(handle);
+    m_sessions.release(handle);
+    m_clients[socket].sessions.removeOne(handle);
+}
+
+bool GameServer::requestAIMove(quint32 handle, GameSession* session)
+{
+    // 复制一份局面快照交给工作线程，会话本身只在主线程中访问
+    auto snapshot = std::make_shared<GameSession>(*session);
+    int ply = session->moveCount;
+    int depth = MinimaxSearch::depthForDifficulty(session->difficulty);
+
+    session->aiPending = true;
+    m_pendingAI++;
+
+    QFuture<QPoint> future = m_scheduler->submit(AIScheduler::Interactive, depth, AI_DEADLINE_MS,
+        [this, handle, ply, snapshot](const AIScheduler::SearchContext& context) {
+            ChessBoard board;
+            snapshot->copyTo(&board);
+
+            // 超过截止时间时返回已搜索部分中的最佳落子
+            MinimaxSearch search(ChessBoard::White, context.depth);
+            search.setStopFlag(context.stop);
+            search.setDeadline(context.deadline);
+            QPoint move = search.findBestMove(&board);
+
+            QMetaObject::invokeMethod(this, [this, handle, ply, move]() {
+                onAIMoveReady(handle, ply, move);
+            }, Qt::QueuedConnection);
+            return move;
+        });
+
+    if (future.isCanceled()) {
+        // 调度器拒绝了请求，解除等待状态，由调用者撤回人类的落子
+        session->aiPending = false;
+        m_pendingAI--;
+        return false;
+    }
+
+    m_aiRequests.insert(handle, future);
+    return true;
+}
+
+void GameServer::cancelAIMove(quint32 handle)
+{
+    auto it = m_aiRequests.find(handle);
+    if (it == m_aiRequests.end()) {
+        return;
+    }
+
+    QFuture<QPoint> future = it.value();
+    m_aiRequests.erase(it);
+
+    // 排队中的请求直接撤销，不会再回调；正在执行的搜索收到停止标志后尽快返回，
+    // 结果回到onAIMoveReady时会话已经释放，只扣减计数
+    if (m_scheduler->cancel(future) && future.isCanceled()) {
+        m_pendingAI--;
+    }
+}
+
+void GameServer::onAIMoveReady(quint32 handle, int ply, const QPoint& move)
+{
+    m_pendingAI--;
+    m_aiRequests.remove(handle);
+
+    // 会话可能已被关闭或槽位已被复用
+    GameSession* session = m_sessions.get(handle);
+    if (!session || session->state == GameSession::Free || !session->aiPending) {
+        return;
+    }
+
+    session->aiPending = false;
+    if (session->moveCount != ply || session->state != GameSession::Playing) {
+        return;
+    }
+
+    QTcpSocket* socket = session->owner;
+    if (!session->play(move.y(), move.x())) {
+        sendLine(socket, "ERR ai failed " + QByteArray::number(handle));
+        return;
+    }
+
+    sendLine(socket, "AI " + QByteArray::number(handle) + ' '
+             + QByteArray::number(move.x()) + ' ' + QByteArray::number(move.y()));
+
+    if (session->state == GameSession::Finished) {
+        notifyGameEnd(socket, handle, session);
+    }
+}
+
+void GameServer::notifyGameEnd(QTcpSocket* socket, quint32 handle, const GameSession* session)
+{
+    QByteArray result = "DRAW";
+    if (session->winner == ChessBoard::Black) {
+        result = "BLACK";
+    } else if (session->winner == ChessBoard::White) {
+        result = "WHITE";
+    }
+    sendLine(socket, "END " + QByteArray::number(handle) + ' ' + result);
+}
+
+void GameServer::sendLine(QTcpSocket* socket, const QByteArray& line)
+{
+    if (socket && socket->state() == QAbstractSocket::ConnectedState) {
+        socket->write(line);
+        socket->write("\n");
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QFuture>
+#include "GameSession.h"
+#include "ai/AIScheduler.h"
+
+// 无界面对局服务器
+// 在同一进程内托管大量对局，使用基于行的文本协议（仅监听localhost）：
+//   NEW <pvp|pvc> [difficulty]  -> OK <sid>
+//   MOVE <sid> <x> <y>          -> OK <sid> <x> <y>，随后可能推送 AI/END 消息；
+//                                  AI队列已满时返回 ERR busy，这步棋不会落下
+//   UNDO <sid>                  -> OK <sid>
+//   BOARD <sid>                 -> BOARD <sid> <225个字符 . X O>
+//   CLOSE <sid>                 -> OK <sid>
+//   STATS                       -> STATS sessions=<n> pending=<n> queued=<n> workers=<n>
+//   QUIT
+// 服务器主动推送：
+//   AI <sid> <x> <y>            AI落子
+//   END <sid> <BLACK|WHITE|DRAW>
+// 出错时返回 ERR <原因>
+class GameServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GameServer(int maxSessions, int workerCount, QObject *parent = nullptr);
+    ~GameServer();
+
+    bool listen(quint16 port);
+    quint16 serverPort() const { return m_server->serverPort(); }
+    QString errorString() const { return m_server->errorString(); }
+
+    int sessionCount() const { return m_sessions.size(); }
+    int pendingAIRequests() const { return m_pendingAI; }
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    struct ClientState {
+        QByteArray buffer;
+        QVector<quint32> sessions;
+    };
+
+    void handleLine(QTcpSocket* socket, const QByteArray& line);
+    void handleNew(QTcpSocket* socket, const QList<QByteArray>& args);
+    void handleMove(QTcpSocket* socket, const QList<QByteArray>& args);
+    void handleUndo(QTcpSocket* socket, const QList<QByteArray>& args);
+    void handleBoard(QTcpSocket* socket, const QList<QByteArray>& args);
+    void handleClose(QTcpSocket* socket, const QList<QByteArray>& args);
+    void handleStats(QTcpSocket* socket);
+
+    GameSession* ownedSession(QTcpSocket* socket, const QByteArray& arg, quint32* handle);
+    void closeSession(QTcpSocket* socket, quint32 handle);
+    bool requestAIMove(quint32 handle, GameSession* session);
+    void cancelAIMove(quint32 handle);
+    void onAIMoveReady(quint32 handle, int ply, const QPoint& move);
+    void notifyGameEnd(QTcpSocket* socket, quint32 handle, const GameSession* session);
+
+    static void sendLine(QTcpSocket* socket, const QByteArray& line);
+
+    QTcpServer* m_server;
+    AIScheduler* m_scheduler;
+    SessionSlab m_sessions;
+    QHash<QTcpSocket*, ClientState> m_clients;
+    QHash<quint32, QFuture<QPoint>> m_aiRequests;  // 各会话已提交、尚未返回的AI请求
+    int m_pendingAI;
+
+    static const int MAX_LINE_LENGTH = 256;
+    static const int AI_DEADLINE_MS = 5000;
+};
+
+#endif // GAMESERVER_H
@@ -0,0 +1,166 @@
+#include "GameSession.h"
+#include <cstring>
+
+namespace {
+const int DIRECTIONS[4][2] = {
+    {0, 1},    // 水平
+    {1, 0},    // 垂直
+    {1, 1},    // 主对角线
+    {1, -1}    // 反对角线
+};
+const int WIN_COUNT = 5;
+}
+
+void GameSession::reset(Mode newMode, int aiDifficulty, QTcpSocket* client)
+{
+    std::memset(cells, 0, sizeof(cells));
+    moveCount = 0;
+    mode = newMode;
+    state = Playing;
+    difficulty = static_cast<quint8>(qBound(1, aiDifficulty, 3));
+    winner = ChessBoard::Empty;
+    aiPending = false;
+    owner = client;
+}
+
+ChessBoard::PieceType GameSession::currentPlayer() const
+{
+    return (moveCount % 2 == 0) ? ChessBoard::Black : ChessBoard::White;
+}
+
+ChessBoard::PieceType GameSession::pieceAt(int row, int col) const
+{
+    if (row < 0 || row >= ChessBoard::BOARD_SIZE || col < 0 || col >= ChessBoard::BOARD_SIZE) {
+        return ChessBoard::Empty;
+    }
+    return static_cast<ChessBoard::PieceType>(cells[row * ChessBoard::BOARD_SIZE + col]);
+}
+
+bool GameSession::play(int row, int col)
+{
+    if (state != Playing) {
+        return false;
+    }
+    if (row < 0 || row >= ChessBoard::BOARD_SIZE || col < 0 || col >= ChessBoard::BOARD_SIZE) {
+        return false;
+    }
+
+    int index = row * ChessBoard::BOARD_SIZE + col;
+    if (cells[index] != ChessBoard::Empty) {
+        return false;
+    }
+
+    ChessBoard::PieceType piece = currentPlayer();
+    cells[index] = static_cast<quint8>(piece);
+    moves[moveCount++] = MoveIndex::fromRowCol(row, col);
+
+    if (checkWin(row, col)) {
+        winner = piece;
+        state = Finished;
+    } else if (isFull()) {
+        winner = ChessBoard::Empty;
+        state = Finished;
+    }
+    return true;
+}
+
+bool GameSession::undo()
+{
+    if (moveCount == 0 || state == Free) {
+        return false;
+    }
+
+    MoveIndex move = moves[--moveCount];
+    cells[move.value()] = ChessBoard::Empty;
+    winner = ChessBoard::Empty;
+    state = Playing;
+    return true;
+}
+
+void GameSession::copyTo(ChessBoard* board) const
+{
+    board->clearBoard();
+    for (int i = 0; i < moveCount; ++i) {
+        MoveIndex move = moves[i];
+        board->placePiece(move.toPoint(), static_cast<ChessBoard::PieceType>(cells[move.value()]));
+    }
+}
+
+bool GameSession::checkWin(int row, int col) const
+{
+    ChessBoard::PieceType piece = pieceAt(row, col);
+    if (piece == ChessBoard::Empty) {
+        return false;
+    }
+
+    for (const auto& dir : DIRECTIONS) {
+        int count = 1;
+        for (int r = row + dir[0], c = col + dir[1]; pieceAt(r, c) == piece; r += dir[0], c += dir[1]) {
+            count++;
+        }
+        for (int r = row - dir[0], c = col - dir[1]; pieceAt(r, c) == piece; r -= dir[0], c -= dir[1]) {
+            count++;
+        }
+        if (count >= WIN_COUNT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// SessionSlab 实现
+SessionSlab::SessionSlab(int capacity)
+    : m_used(0)
+{
+    capacity = qBound(1, capacity, 0xFFFF);
+    m_slots.resize(capacity);
+    std::memset(static_cast<void*>(m_slots.data()), 0, sizeof(GameSession) * capacity);
+
+    // 倒序压栈，使低下标槽位优先分配
+    m_freeList.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; --i) {
+        m_freeList.append(static_cast<quint16>(i));
+    }
+}
+
+quint32 SessionSlab::allocate()
+{
+    if (m_freeList.isEmpty()) {
+        return INVALID_HANDLE;
+    }
+
+    int index = m_freeList.takeLast();
+    m_used++;
+    return makeHandle(index, m_slots[index].generation);
+}
+
+void SessionSlab::release(quint32 handle)
+{
+    GameSession* session = get(handle);
+    if (!session) {
+        return;
+    }
+
+    int index = static_cast<int>(handle & 0xFFFF);
+    session->state = GameSession::Free;
+    session->owner = nullptr;
+    session->aiPending = false;
+    session->generation++;
+    m_freeList.append(static_cast<quint16>(index));
+    m_used--;
+}
+
+GameSession* SessionSlab::get(quint32 handle)
+{
+    int index = static_cast<int>(handle & 0xFFFF);
+    quint16 generation = static_cast<quint16>(handle >> 16);
+    if (index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    GameSession& session = m_slots[index];
+    if (session.generation != generation) {
+        return nullptr;
+    }
+    return &session;
+}
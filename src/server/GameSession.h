@@ -0,0 +1,78 @@
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPoint>
+#include "core/ChessBoard.h"
+#include "core/MoveIndex.h"
+
+class QTcpSocket;
+
+// 服务器端的紧凑对局状态
+// 不继承QObject，直接存放在SessionSlab的连续数组中，每局约500字节
+struct GameSession
+{
+    enum Mode : quint8 { PvP = 0, PvC = 1 };
+    enum State : quint8 { Free = 0, Playing = 1, Finished = 2 };
+
+    static const int CELL_COUNT = ChessBoard::BOARD_SIZE * ChessBoard::BOARD_SIZE;
+
+    quint8 cells[CELL_COUNT];     // 0=空 1=黑 2=白，下标为 row*15+col
+    MoveIndex moves[CELL_COUNT];  // 落子历史
+    quint8 moveCount;
+    quint8 mode;
+    quint8 state;
+    quint8 difficulty;
+    quint8 winner;                // ChessBoard::PieceType，平局为Empty
+    bool aiPending;               // AI请求是否已提交到工作线程池
+    quint16 generation;           // 槽位复用计数，用于识别过期句柄
+    QTcpSocket* owner;
+
+    void reset(Mode newMode, int aiDifficulty, QTcpSocket* client);
+
+    ChessBoard::PieceType currentPlayer() const;
+    ChessBoard::PieceType pieceAt(int row, int col) const;
+    bool isFull() const { return moveCount >= CELL_COUNT; }
+
+    // 落子/悔棋，成功后自动更新胜负状态
+    bool play(int row, int col);
+    bool undo();
+
+    // 导出为ChessBoard（包括历史），供AI搜索使用
+    void copyTo(ChessBoard* board) const;
+
+private:
+    bool checkWin(int row, int col) const;
+};
+
+// 会话槽位分配器
+// 句柄 = (generation << 16) | index，槽位释放后generation递增，旧句柄自动失效
+class SessionSlab
+{
+public:
+    explicit SessionSlab(int capacity);
+
+    int capacity() const { return m_slots.size(); }
+    int size() const { return m_used; }
+
+    quint32 allocate();
+    void release(quint32 handle);
+    GameSession* get(quint32 handle);
+
+    static const quint32 INVALID_HANDLE = 0xFFFFFFFFu;
+
+private:
+    static quint32 makeHandle(int index, quint16 generation)
+    {
+        return (static_cast<quint32>(generation) << 16) | static_cast<quint32>(index);
+    }
+
+    QVector<GameSession> m_slots;
+    QVector<quint16> m_freeList;
+    int m_used;
+};
+
+Q_DECLARE_TYPEINFO(GameSession, Q_PRIMITIVE_TYPE);
+
+#endif // GAMESESSION_H
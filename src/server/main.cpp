@@ -0,0 +1,39 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QThread>
+#include <QDebug>
+
+#include "server/GameServer.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("GobangServer");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("五子棋对局服务器（仅监听localhost）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption portOption({"p", "port"}, "监听端口", "port", "5555");
+    QCommandLineOption workersOption({"w", "workers"}, "AI工作线程数", "count",
+                                     QString::number(qMax(1, QThread::idealThreadCount())));
+    QCommandLineOption sessionsOption({"s", "max-sessions"}, "最大同时对局数", "count", "4096");
+    parser.addOption(portOption);
+    parser.addOption(workersOption);
+    parser.addOption(sessionsOption);
+    parser.process(app);
+
+    GameServer server(parser.value(sessionsOption).toInt(),
+                      parser.value(workersOption).toInt());
+
+    if (!server.listen(static_cast<quint16>(parser.value(portOption).toUInt()))) {
+        qCritical() << "无法启动服务器:" << server.errorString();
+        return 1;
+    }
+
+    qDebug() << "五子棋服务器已启动，端口:" << server.serverPort();
+
+    return app.exec();
+}
@@ -0,0 +1,446 @@
+#include "GLBoardView.h"
+#include "GameWidget.h"
+#include "managers/ConfigManager.h"
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QPainter>
+#include <QDebug>
+#include <QVector2D>
+#include <cstddef>
+
+namespace {
+
+// 顶点着色器：单位矩形按实例的中心和半尺寸展开，坐标以逻辑像素给出
+const char* const VERTEX_SHADER = R"(
+layout(location = 0) in vec2 a_corner;
+layout(location = 1) in vec4 a_rect;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in vec2 a_shape;
+
+uniform vec2 u_viewport;
+
+out vec2 v_local;
+out vec4 v_color;
+flat out vec2 v_shape;
+flat out float v_halfSize;
+
+void main()
+{
+    vec2 position = a_rect.xy + a_corner * a_rect.zw;
+    v_local = a_corner;
+    v_color = a_color;
+    v_shape = a_shape;
+    v_halfSize = a_rect.z;
+    gl_Position = vec4(position.x / u_viewport.x * 2.0 - 1.0,
+                       1.0 - position.y / u_viewport.y * 2.0, 0.0, 1.0);
+}
+)";
+
+// 片段着色器：按形状计算覆盖率，圆边用fwidth做一个像素宽的抗锯齿
+const char* const FRAGMENT_SHADER = R"(
+in vec2 v_local;
+in vec4 v_color;
+flat in vec2 v_shape;
+flat in float v_halfSize;
+
+uniform sampler2D u_texture;
+
+out vec4 fragColor;
+
+void main()
+{
+    int shape = int(v_shape.x + 0.5);
+    float r = length(v_local);
+    float aa = max(fwidth(r), 1e-4);
+    float inside = 1.0 - smoothstep(1.0 - aa, 1.0, r);
+
+    if (shape == 0) {
+        fragColor = v_color;
+    } else if (shape == 1) {
+        // 高光偏左上的立体棋子，边缘略暗形成轮廓
+        float light = 1.0 - clamp(length(v_local - vec2(-0.35, -0.35)) / 1.3, 0.0, 1.0);
+        vec3 color = v_color.rgb * (0.75 + 0.25 * light) + vec3(light * light * mix(0.15, 0.6, v_shape.y));
+        color *= mix(1.0, 0.6, smoothstep(1.0 - 3.0 * aa, 1.0 - aa, r));
+        fragColor = vec4(color, v_color.a * inside);
+    } else if (shape == 2) {
+        float thickness = v_shape.y / v_halfSize;
+        float ring = smoothstep(1.0 - thickness - aa, 1.0 - thickness, r) * inside;
+        fragColor = vec4(v_color.rgb, v_color.a * ring);
+    } else if (shape == 3) {
+        fragColor = vec4(v_color.rgb, v_color.a * (1.0 - smoothstep(0.6, 1.0, r)));
+    } else if (shape == 4) {
+        vec4 texel = texture(u_texture, v_local * 0.5 + 0.5);
+        fragColor = vec4(texel.rgb, texel.a * v_color.a);
+    } else {
+        fragColor = vec4(v_color.rgb, v_color.a * inside);
+    }
+}
+)";
+
+const float QUAD_CORNERS[8] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+}
+
+GLBoardView::GLBoardView(GameWidget* owner)
+    : QOpenGLWidget(owner)
+    , m_owner(owner)
+    , m_initialized(false)
+    , m_quadBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_instanceBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_instanceCapacity(0)
+    , m_backgroundTexture(0)
+    , m_whiteTexture(0)
+    , m_backgroundKey(0)
+{
+    setFormat(requiredFormat());
+}
+
+GLBoardView::~GLBoardView()
+{
+    makeCurrent();
+    releaseResources();
+    doneCurrent();
+}
+
+QSurfaceFormat GLBoardView::requiredFormat()
+{
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    if (QOpenGLContext::openGLModuleType() == QOpenGLContext::LibGLES) {
+        format.setRenderableType(QSurfaceFormat::OpenGLES);
+        format.setVersion(3, 0);
+    } else {
+        format.setRenderableType(QSurfaceFormat::OpenGL);
+        format.setVersion(3, 3);
+        format.setProfile(QSurfaceFormat::CoreProfile);
+    }
+    return format;
+}
+
+bool GLBoardView::versionSufficient(const QOpenGLContext* context)
+{
+    const QPair<int, int> version = context->format().version();
+    if (context->isOpenGLES()) {
+        return version >= qMakePair(3, 0);
+    }
+    return version >= qMakePair(3, 3);
+}
+
+bool GLBoardView::isSupported()
+{
+    QOffscreenSurface surface;
+    surface.setFormat(requiredFormat());
+    surface.create();
+
+    QOpenGLContext context;
+    context.setFormat(requiredFormat());
+    if (!surface.isValid() || !context.create() || !context.makeCurrent(&surface)) {
+        return false;
+    }
+
+    bool supported = versionSufficient(&context);
+    context.doneCurrent();
+    return supported;
+}
+
+void GLBoardView::initializeGL()
+{
+    if (!versionSufficient(context())) {
+        QMetaObject::invokeMethod(this, &GLBoardView::initializationFailed, Qt::QueuedConnection);
+        return;
+    }
+
+    initializeOpenGLFunctions();
+
+    const QByteArray header = context()->isOpenGLES()
+        ? QByteArray("#version 300 es\nprecision mediump float;\n")
+        : QByteArray("#version 330 core\n");
+    if (!m_program.addShaderFromSourceCode(QOpenGLShader::Vertex, header + VERTEX_SHADER) ||
+        !m_program.addShaderFromSourceCode(QOpenGLShader::Fragment, header + FRAGMENT_SHADER) ||
+        !m_program.link()) {
+        qWarning() << "棋盘着色器编译失败:" << m_program.log();
+        QMetaObject::invokeMethod(this, &GLBoardView::initializationFailed, Qt::QueuedConnection);
+        return;
+    }
+
+    m_vao.create();
+    QOpenGLVertexArrayObject::Binder binder(&m_vao);
+
+    m_quadBuffer.create();
+    m_quadBuffer.bind();
+    m_quadBuffer.allocate(QUAD_CORNERS, sizeof(QUAD_CORNERS));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+
+    // 每个实例一组属性：矩形、颜色、形状参数
+    m_instanceBuffer.create();
+    m_instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_instanceBuffer.bind();
+    const GLsizei stride = sizeof(QuadInstance);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void*>(offsetof(QuadInstance, centerX)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void*>(offsetof(QuadInstance, red)));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void*>(offsetof(QuadInstance, shape)));
+    glVertexAttribDivisor(3, 1);
+
+    // 没有背景图时绑定1x1白色纹理，着色器不必分支判断
+    const quint32 white = 0xFFFFFFFFu;
+    glGenTextures(1, &m_whiteTexture);
+    glBindTexture(GL_TEXTURE_2D, m_whiteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    m_initialized = true;
+}
+
+void GLBoardView::paintGL()
+{
+    // 初始化失败时函数表未解析，等待GameWidget回退到光栅绘制
+    if (!m_initialized) {
+        return;
+    }
+
+    const QColor clearColor = m_owner->palette().color(QPalette::Window);
+    glClearColor(clearColor.redF(), clearColor.greenF(), clearColor.blueF(), 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    updateBackgroundTexture();
+    buildInstances();
+
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_program.bind();
+    m_program.setUniformValue("u_viewport", QVector2D(width(), height()));
+    m_program.setUniformValue("u_texture", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_backgroundTexture ? m_backgroundTexture : m_whiteTexture);
+
+    QOpenGLVertexArrayObject::Binder binder(&m_vao);
+    m_instanceBuffer.bind();
+    const int bytes = m_instances.size() * static_cast<int>(sizeof(QuadInstance));
+    if (m_instances.size() > m_instanceCapacity) {
+        // 按两倍扩容，正常对局中很快稳定下来，之后只做子区域更新
+        m_instanceCapacity = qMax(256, m_instances.size() * 2);
+        m_instanceBuffer.allocate(m_instanceCapacity * static_cast<int>(sizeof(QuadInstance)));
+    }
+    m_instanceBuffer.write(0, m_instances.constData(), bytes);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_instances.size());
+
+    m_program.release();
+    glDisable(GL_BLEND);
+
+    drawText();
+}
+
+void GLBoardView::buildInstances()
+{
+    m_instances.clear();
+
+    GameWidget* w = m_owner;
+    const QRect& boardRect = w->m_boardRect;
+    const int cellSize = w->m_cellSize;
+
+    // 背景图按KeepAspectRatioByExpanding居中，超出视口的部分由裁剪去掉
+    if (!w->m_backgroundImage.isNull()) {
+        QSizeF imageSize = QSizeF(w->m_backgroundImage.size()).scaled(size(), Qt::KeepAspectRatioByExpanding);
+        QRectF imageRect(QPointF(0, 0), imageSize);
+        imageRect.moveCenter(QRectF(rect()).center());
+        QColor tint(Qt::white);
+        tint.setAlphaF(ConfigManager::instance()->backgroundOpacity());
+        addQuad(imageRect, tint, Textured);
+    }
+
+    QColor boardColor = w->m_boardColor;
+    boardColor.setAlpha(180);
+    addQuad(boardRect, boardColor, SolidRect);
+
+    // 网格线是1像素宽的细矩形
+    for (int i = 0; i < ChessBoard::BOARD_SIZE; ++i) {
+        const qreal x = boardRect.left() + i * cellSize;
+        const qreal y = boardRect.top() + i * cellSize;
+        addQuad(QRectF(x - 0.5, boardRect.top(), 1.0, boardRect.height()), w->m_lineColor, SolidRect);
+        addQuad(QRectF(boardRect.left(), y - 0.5, boardRect.width(), 1.0), w->m_lineColor, SolidRect);
+    }
+    addCircle(w->boardToPixel(QPoint(7, 7)), 3, w->m_lineColor, Disc);
+
+    ChessBoard* board = w->m_gameEngine ? w->m_gameEngine->chessBoard() : nullptr;
+    if (board && w->m_heatmapMode != GameWidget::HeatmapOff) {
+        const qreal half = cellSize * 0.45;
+        for (int cell = 0; cell < SearchHeatmap::CELL_COUNT; ++cell) {
+            const float level = w->m_heatmapLevels[cell];
+            const int row = cell / ChessBoard::BOARD_SIZE;
+            const int col = cell % ChessBoard::BOARD_SIZE;
+            if (level < 0.0f || board->pieceAt(row, col) != ChessBoard::Empty) {
+                continue;
+            }
+            const QPointF center = w->boardToPixel(QPoint(col, row));
+            addQuad(QRectF(center.x() - half, center.y() - half, half * 2, half * 2),
+                    w->heatmapColor(level), SolidRect);
+        }
+    }
+
+    if (board) {
+        const qreal radius = qMax(3, cellSize / 3);
+        const QPoint lastMove = (w->m_showLastMove && board->hasHistory()) ? board->lastMove() : QPoint(-1, -1);
+
+        for (int row = 0; row < ChessBoard::BOARD_SIZE; ++row) {
+            for (int col = 0; col < ChessBoard::BOARD_SIZE; ++col) {
+                ChessBoard::PieceType piece = board->pieceAt(row, col);
+                if (piece == ChessBoard::Empty) {
+                    continue;
+                }
+
+                const QPoint position(col, row);
+                const QPointF center = w->boardToPixel(position);
+                if (w->m_winningLine.contains(position)) {
+                    addCircle(center, radius + 4, QColor(255, 215, 0, 200), Glow);
+                }
+                addCircle(center + QPointF(1.5, 1.5), radius, QColor(0, 0, 0, 60), Disc);
+
+                const bool black = (piece == ChessBoard::Black);
+                addCircle(center, radius, black ? w->m_blackPieceColor : w->m_whitePieceColor,
+                          ShadedStone, black ? 1.0f : 0.0f);
+
+                if (position == lastMove) {
+                    addCircle(center, qMin(radius + 2, cellSize / 2.0 - 1), w->m_lastMoveColor, Ring, 2.0f);
+                }
+            }
+        }
+
+        const qreal hintRadius = qMax(5, cellSize / 3);
+        for (int rank = w->m_hints.size() - 1; rank >= 0; --rank) {
+            const QPoint& move = w->m_hints[rank].move;
+            if (!board->isEmpty(move)) {
+                continue;
+            }
+            QColor fill = w->m_hintColor;
+            fill.setAlpha(rank == 0 ? 170 : 90);
+            const QPointF center = w->boardToPixel(move);
+            addCircle(center, hintRadius, fill, Disc);
+            addCircle(center, hintRadius, w->m_hintColor.darker(), Ring, rank == 0 ? 2.0f : 1.0f);
+        }
+    }
+
+    const QPoint hoverPosition = w->visibleHoverPosition();
+    if (hoverPosition.x() >= 0) {
+        addCircle(w->boardToPixel(hoverPosition), qMax(3, cellSize / 4), w->m_hoverColor, Disc);
+    }
+}
+
+void GLBoardView::addQuad(const QRectF& rect, const QColor& color, Shape shape, float param)
+{
+    QuadInstance instance;
+    instance.centerX = static_cast<float>(rect.center().x());
+    instance.centerY = static_cast<float>(rect.center().y());
+    instance.halfWidth = static_cast<float>(rect.width() / 2.0);
+    instance.halfHeight = static_cast<float>(rect.height() / 2.0);
+    instance.red = static_cast<float>(color.redF());
+    instance.green = static_cast<float>(color.greenF());
+    instance.blue = static_cast<float>(color.blueF());
+    instance.alpha = static_cast<float>(color.alphaF());
+    instance.shape = static_cast<float>(shape);
+    instance.param = param;
+    m_instances.append(instance);
+}
+
+void GLBoardView::addCircle(const QPointF& center, qreal radius, const QColor& color, Shape shape, float param)
+{
+    addQuad(QRectF(center.x() - radius, center.y() - radius, radius * 2, radius * 2), color, shape, param);
+}
+
+void GLBoardView::updateBackgroundTexture()
+{
+    const QImage& image = m_owner->m_backgroundImage;
+    const qint64 key = image.isNull() ? 0 : image.cacheKey();
+    if (key == m_backgroundKey) {
+        return;
+    }
+    m_backgroundKey = key;
+
+    if (m_backgroundTexture) {
+        glDeleteTextures(1, &m_backgroundTexture);
+        m_backgroundTexture = 0;
+    }
+    if (image.isNull()) {
+        return;
+    }
+
+    // 图片首行对应纹理坐标0，与着色器中自上而下的坐标一致，无需翻转
+    const QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+    glGenTextures(1, &m_backgroundTexture);
+    glBindTexture(GL_TEXTURE_2D, m_backgroundTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, rgba.width(), rgba.height(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, rgba.constBits());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void GLBoardView::drawText()
+{
+    GameWidget* w = m_owner;
+    const bool hasHints = !w->m_hints.isEmpty() && w->m_gameEngine && w->m_gameEngine->chessBoard();
+    if (!w->m_showCoordinates && !hasHints) {
+        return;
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    if (w->m_showCoordinates) {
+        w->drawCoordinates(painter);
+    }
+
+    if (hasHints) {
+        ChessBoard* board = w->m_gameEngine->chessBoard();
+        const int radius = qMax(5, w->m_cellSize / 3);
+        QFont font = painter.font();
+        font.setPointSize(qMax(7, w->m_cellSize / 3));
+        font.setBold(true);
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+
+        for (int rank = 0; rank < w->m_hints.size(); ++rank) {
+            const QPoint& move = w->m_hints[rank].move;
+            if (!board->isEmpty(move)) {
+                continue;
+            }
+            const QPoint center = w->boardToPixel(move);
+            painter.drawText(QRect(center.x() - radius, center.y() - radius, radius * 2, radius * 2),
+                             Qt::AlignCenter, QString::number(rank + 1));
+        }
+    }
+}
+
+void GLBoardView::releaseResources()
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    if (m_backgroundTexture) {
+        glDeleteTextures(1, &m_backgroundTexture);
+        m_backgroundTexture = 0;
+    }
+    if (m_whiteTexture) {
+        glDeleteTextures(1, &m_whiteTexture);
+        m_whiteTexture = 0;
+    }
+    m_instanceBuffer.destroy();
+    m_quadBuffer.destroy();
+    m_vao.destroy();
+    m_program.removeAllShaders();
+    m_initialized = false;
+}
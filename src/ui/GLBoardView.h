@@ -0,0 +1,83 @@
+#ifndef GLBOARDVIEW_H
+#define GLBOARDVIEW_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLBuffer>
+#include <QVector>
+#include <QColor>
+#include <QRectF>
+
+class GameWidget;
+
+// GameWidget的OpenGL渲染器
+// 背景、棋盘、网格、棋子和各种标记都表示为带形状参数的矩形实例，
+// 每帧把实例数组上传一次，用一次实例化绘制调用画完；只有坐标和提示序号这类文字用QPainter叠加。
+// 需要OpenGL 3.3或OpenGL ES 3.0，创建前用isSupported()探测。
+class GLBoardView : public QOpenGLWidget, protected QOpenGLExtraFunctions
+{
+    Q_OBJECT
+
+public:
+    explicit GLBoardView(GameWidget* owner);
+    ~GLBoardView();
+
+    // 当前平台能否创建满足要求的上下文
+    static bool isSupported();
+
+signals:
+    void initializationFailed();
+
+protected:
+    void initializeGL() override;
+    void paintGL() override;
+
+private:
+    // 着色器根据shape决定如何填充实例矩形
+    enum Shape {
+        SolidRect = 0,
+        ShadedStone = 1,
+        Ring = 2,
+        Glow = 3,
+        Textured = 4,
+        Disc = 5
+    };
+
+    // 与顶点属性布局一一对应
+    struct QuadInstance {
+        float centerX, centerY;
+        float halfWidth, halfHeight;
+        float red, green, blue, alpha;
+        float shape;
+        float param;
+    };
+
+    void buildInstances();
+    void addQuad(const QRectF& rect, const QColor& color, Shape shape, float param = 0.0f);
+    void addCircle(const QPointF& center, qreal radius, const QColor& color, Shape shape, float param = 0.0f);
+    void updateBackgroundTexture();
+    void drawText();
+    void releaseResources();
+
+    static QSurfaceFormat requiredFormat();
+    static bool versionSufficient(const QOpenGLContext* context);
+
+    GameWidget* m_owner;
+    bool m_initialized;
+
+    QOpenGLShaderProgram m_program;
+    QOpenGLVertexArrayObject m_vao;
+    QOpenGLBuffer m_quadBuffer;
+    QOpenGLBuffer m_instanceBuffer;
+    int m_instanceCapacity;
+
+    GLuint m_backgroundTexture;
+    GLuint m_whiteTexture;
+    qint64 m_backgroundKey;
+
+    QVector<QuadInstance> m_instances;
+};
+
+#endif // GLBOARDVIEW_H
@@ -1,16 +1,26 @@
 #include "GameWidget.h"
 #include <QPainter>
+#include <QRadialGradient>
 #include <QMouseEvent>
+#include <QPaintEvent>
 #include <QDebug>
 #include <QPixmap>
 #include <QFileInfo>
+#include <QImageReader>
+#include <QtConcurrent>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
 #include "managers/AudioManager.h"
 #include "managers/ConfigManager.h"
+#include "GLBoardView.h"
 
 // 定义static const成员变量
 const int GameWidget::MIN_CELL_SIZE;
 const int GameWidget::MAX_CELL_SIZE;
 const int GameWidget::BOARD_MARGIN;
+const int GameWidget::MAX_BACKGROUND_DIMENSION;
+const int GameWidget::HEATMAP_FPS;
 
 GameWidget::GameWidget(QWidget *parent)
     : QWidget(parent)
@@ -19,15 +29,48 @@ GameWidget::GameWidget(QWidget *parent)
     , m_hoverPosition(-1, -1)
     , m_showCoordinates(true)
     , m_showLastMove(true)
+    , m_markedLastMove(-1, -1)
     , m_boardColor(QColor(218, 165, 32))      // 金色棋盘
     , m_lineColor(QColor(139, 69, 19))        // 棕色线条
     , m_blackPieceColor(Qt::black)
     , m_whitePieceColor(Qt::white)
     , m_lastMoveColor(Qt::red)
     , m_hoverColor(QColor(255, 255, 0, 128))  // 半透明黄色
+    , m_hintColor(QColor(30, 144, 255))       // 道奇蓝
+    , m_boardCacheValid(false)
+    , m_pieceRadius(10)
+    , m_spriteCellSize(0)
+    , m_spriteRatio(0.0)
+    , m_scaledBackgroundOpacity(-1.0f)
+    , m_backgroundWatcher(new QFutureWatcher<QImage>(this))
+    , m_heatmapSource(nullptr)
+    , m_heatmapMode(HeatmapOff)
+    , m_heatmapTimer(new QTimer(this))
+    , m_heatmapSequence(0)
+    , m_glView(nullptr)
 {
     setMouseTracking(true);
     setMinimumSize(400, 400);
+    
+    connect(m_backgroundWatcher, &QFutureWatcher<QImage>::finished,
+            this, &GameWidget::onBackgroundDecoded);
+    
+    std::fill(std::begin(m_heatmapLevels), std::end(m_heatmapLevels), -1.0f);
+    m_heatmapTimer->setInterval(1000 / HEATMAP_FPS);
+    connect(m_heatmapTimer, &QTimer::timeout, this, &GameWidget::onHeatmapTick);
+    
+    ConfigManager* configManager = ConfigManager::instance();
+    connect(configManager, &ConfigManager::backgroundImageChanged,
+            this, &GameWidget::onBackgroundImageChanged);
+    connect(configManager, &ConfigManager::themeChanged,
+            this, &GameWidget::invalidateBoardCache);
+    
+    connect(configManager, &ConfigManager::rendererChanged,
+            this, &GameWidget::setRenderer);
+    
+    // 启动时就开始解码，棋盘先不带背景显示出来
+    onBackgroundImageChanged(configManager->backgroundImage());
+    setRenderer(configManager->renderer());
 }
 
 void GameWidget::setGameEngine(GameEngine* engine)
@@ -47,14 +90,14 @@ void GameWidget::setGameEngine(GameEngine* engine)
                 this, &GameWidget::onGameStateChanged);
     }
     
-    update();
+    requestRepaint();
 }
 
 void GameWidget::setShowCoordinates(bool show)
 {
     if (m_showCoordinates != show) {
         m_showCoordinates = show;
-        update();
+        invalidateBoardCache();
     }
 }
 
@@ -62,35 +105,162 @@ void GameWidget::setShowLastMove(bool show)
 {
     if (m_showLastMove != show) {
         m_showLastMove = show;
-        update();
+        requestRepaint();
     }
 }
 
-void GameWidget::paintEvent(QPaintEvent *event)
+void GameWidget::setHints(const QVector<MinimaxSearch::RootMove>& hints)
 {
-    Q_UNUSED(event)
+    updateHintCells();
+    m_hints = hints;
+    updateHintCells();
+}
+
+void GameWidget::clearHints()
+{
+    if (!m_hints.isEmpty()) {
+        updateHintCells();
+        m_hints.clear();
+    }
+}
+
+void GameWidget::invalidateBoardCache()
+{
+    m_boardCacheValid = false;
+    requestRepaint();
+}
+
+void GameWidget::setHeatmap(const SearchHeatmap* source, HeatmapMode mode)
+{
+    if (!source) {
+        mode = HeatmapOff;
+    }
+    m_heatmapSource = source;
+    m_heatmapMode = mode;
+    m_heatmapSequence = 0;
+    std::fill(std::begin(m_heatmapLevels), std::end(m_heatmapLevels), -1.0f);
+    
+    // 搜索线程写多快都不影响界面：只按固定帧率检查一次序号
+    if (mode == HeatmapOff) {
+        m_heatmapTimer->stop();
+    } else {
+        m_heatmapTimer->start();
+    }
+    requestRepaint();
+}
+
+void GameWidget::onHeatmapTick()
+{
+    if (!m_heatmapSource || !m_heatmapSource->snapshot(&m_heatmapSnapshot, m_heatmapSequence)) {
+        return;
+    }
+    m_heatmapSequence = m_heatmapSnapshot.sequence;
     
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    std::fill(std::begin(m_heatmapLevels), std::end(m_heatmapLevels), -1.0f);
     
-    // 计算棋盘区域
-    m_boardRect = calculateBoardRect();
-    m_cellSize = m_boardRect.width() / (ChessBoard::BOARD_SIZE - 1);
+    if (m_heatmapMode == HeatmapVisits) {
+        // 节点数差异可达数个数量级，按对数归一化
+        quint32 maxVisits = 0;
+        for (quint32 visits : m_heatmapSnapshot.visits) {
+            maxVisits = qMax(maxVisits, visits);
+        }
+        if (maxVisits > 0) {
+            const float scale = std::log1p(static_cast<float>(maxVisits));
+            for (int i = 0; i < SearchHeatmap::CELL_COUNT; ++i) {
+                if (m_heatmapSnapshot.visits[i] > 0) {
+                    m_heatmapLevels[i] = std::log1p(static_cast<float>(m_heatmapSnapshot.visits[i])) / scale;
+                }
+            }
+        }
+    } else {
+        // 分数中有胜负级别的极值，按名次归一化才能看出中间着法的差别
+        int order[SearchHeatmap::CELL_COUNT];
+        int count = 0;
+        for (int i = 0; i < SearchHeatmap::CELL_COUNT; ++i) {
+            if (m_heatmapSnapshot.scores[i] != SearchHeatmap::NO_SCORE) {
+                order[count++] = i;
+            }
+        }
+        std::sort(order, order + count, [this](int a, int b) {
+            return m_heatmapSnapshot.scores[a] < m_heatmapSnapshot.scores[b];
+        });
+        for (int rank = 0; rank < count; ++rank) {
+            m_heatmapLevels[order[rank]] = count > 1 ? static_cast<float>(rank) / (count - 1) : 1.0f;
+        }
+    }
     
-    // 绘制各个部分
-    drawBackground(painter);
-    drawBoard(painter);
+    requestRepaint(m_boardRect.adjusted(-m_cellSize, -m_cellSize, m_cellSize, m_cellSize));
+}
+
+void GameWidget::setRenderer(const QString& renderer)
+{
+    const bool useOpenGL = (renderer == "opengl");
+    if (useOpenGL == (m_glView != nullptr)) {
+        return;
+    }
     
-    if (m_showCoordinates) {
-        drawCoordinates(painter);
+    if (useOpenGL) {
+        // 先探测驱动是否支持所需的GL版本，不支持时保持光栅绘制
+        if (!GLBoardView::isSupported()) {
+            qWarning() << "OpenGL 3.3 / ES 3.0 不可用，使用光栅绘制";
+            return;
+        }
+        m_glView = new GLBoardView(this);
+        m_glView->setAttribute(Qt::WA_TransparentForMouseEvents);
+        m_glView->setGeometry(rect());
+        connect(m_glView, &GLBoardView::initializationFailed,
+                this, &GameWidget::onOpenGLUnavailable);
+        m_glView->show();
+    } else {
+        delete m_glView;
+        m_glView = nullptr;
+        invalidateBoardCache();
+    }
+}
+
+void GameWidget::onOpenGLUnavailable()
+{
+    qWarning() << "OpenGL渲染器初始化失败，回退到光栅绘制";
+    m_glView->deleteLater();
+    m_glView = nullptr;
+    invalidateBoardCache();
+}
+
+void GameWidget::requestRepaint(const QRect& rect)
+{
+    // OpenGL视图每帧重新提交全部实例，局部区域没有意义
+    if (m_glView) {
+        m_glView->update();
+    } else if (rect.isNull()) {
+        update();
+    } else {
+        update(rect);
+    }
+}
+
+void GameWidget::paintEvent(QPaintEvent *event)
+{
+    // OpenGL视图覆盖整个控件，由它负责绘制
+    if (m_glView) {
+        return;
     }
     
-    drawPieces(painter);
+    QPainter painter(this);
     
-    if (m_showLastMove) {
-        drawLastMove(painter);
+    if (!m_boardCacheValid) {
+        rebuildBoardCache();
     }
     
+    // 静态部分直接从缓存拷贝，只覆盖需要重绘的区域
+    const QRect dirtyRect = event->rect();
+    const qreal ratio = m_boardCache.devicePixelRatio();
+    painter.drawPixmap(QPointF(dirtyRect.topLeft()), m_boardCache,
+                       QRectF(QPointF(dirtyRect.topLeft()) * ratio, QSizeF(dirtyRect.size()) * ratio));
+    
+    painter.setRenderHint(QPainter::Antialiasing);
+    drawHeatmap(painter, dirtyRect);
+    drawPieces(painter, dirtyRect);
+    drawHints(painter);
     drawHoverEffect(painter);
 }
 
@@ -120,75 +290,247 @@ void GameWidget::mouseMoveEvent(QMouseEvent *event)
 {
     QPoint boardPos = pixelToBoard(event->pos());
     if (boardPos != m_hoverPosition) {
+        // 只重绘离开和进入的两个格子
+        updateCell(m_hoverPosition);
         m_hoverPosition = boardPos;
-        update();
+        updateCell(m_hoverPosition);
     }
 }
 
 void GameWidget::resizeEvent(QResizeEvent *event)
 {
     Q_UNUSED(event)
-    update();
+    updateBoardGeometry();
+    if (m_glView) {
+        m_glView->setGeometry(rect());
+    }
+    invalidateBoardCache();
 }
 
 void GameWidget::leaveEvent(QEvent *event)
 {
     Q_UNUSED(event)
+    updateCell(m_hoverPosition);
     m_hoverPosition = QPoint(-1, -1);
-    update();
 }
 
 void GameWidget::onMoveMade(const QPoint& position, ChessBoard::PieceType piece)
 {
-    Q_UNUSED(position)
     Q_UNUSED(piece)
-    update();
+    clearHints();
+    updateCell(position);
+    updateCell(m_markedLastMove);
+    // 轮到的一方变化会影响悬停提示是否显示
+    updateCell(m_hoverPosition);
 }
 
 void GameWidget::onMoveUndone(const QPoint& position)
 {
-    Q_UNUSED(position)
-    update();
+    clearHints();
+    updateCell(position);
+    updateCell(m_markedLastMove);
+    if (m_gameEngine && m_gameEngine->chessBoard() && m_gameEngine->chessBoard()->hasHistory()) {
+        updateCell(m_gameEngine->chessBoard()->lastMove());
+    }
+    updateCell(m_hoverPosition);
 }
 
 void GameWidget::onGameStateChanged(GameEngine::GameState state)
 {
-    Q_UNUSED(state)
-    update();
+    m_hints.clear();
+    // 判胜时得到的获胜线由引擎保存，翻看棋谱回到终局局面时同样从这里取
+    if (state == GameEngine::Finished) {
+        m_winningLine = m_gameEngine->winningLine();
+    } else {
+        m_winningLine = GameRule::WinLine();
+    }
+    requestRepaint();
+}
+
+void GameWidget::updateBoardGeometry()
+{
+    m_boardRect = calculateBoardRect();
+    m_cellSize = m_boardRect.width() / (ChessBoard::BOARD_SIZE - 1);
+}
+
+void GameWidget::rebuildBoardCache()
+{
+    updateBoardGeometry();
+    
+    // 按设备像素比创建，高分屏上不会模糊
+    const qreal ratio = devicePixelRatioF();
+    m_boardCache = QPixmap(size() * ratio);
+    m_boardCache.setDevicePixelRatio(ratio);
+    m_boardCache.fill(Qt::transparent);
+    
+    QPainter painter(&m_boardCache);
+    painter.setRenderHint(QPainter::Antialiasing);
+    drawBackground(painter);
+    drawBoard(painter);
+    
+    if (m_showCoordinates) {
+        drawCoordinates(painter);
+    }
+    
+    rebuildPieceSprites();
+    m_boardCacheValid = true;
+}
+
+void GameWidget::rebuildPieceSprites()
+{
+    const qreal ratio = devicePixelRatioF();
+    if (m_spriteCellSize == m_cellSize && qFuzzyCompare(m_spriteRatio, ratio)) {
+        return;
+    }
+    
+    m_pieceRadius = qMax(3, m_cellSize / 3);
+    m_pieceSprites[BlackStone] = renderPieceSprite(ChessBoard::Black, BlackStone, ratio);
+    m_pieceSprites[WhiteStone] = renderPieceSprite(ChessBoard::White, WhiteStone, ratio);
+    m_pieceSprites[BlackLastMove] = renderPieceSprite(ChessBoard::Black, BlackLastMove, ratio);
+    m_pieceSprites[WhiteLastMove] = renderPieceSprite(ChessBoard::White, WhiteLastMove, ratio);
+    m_pieceSprites[BlackWinning] = renderPieceSprite(ChessBoard::Black, BlackWinning, ratio);
+    m_pieceSprites[WhiteWinning] = renderPieceSprite(ChessBoard::White, WhiteWinning, ratio);
+    
+    m_spriteCellSize = m_cellSize;
+    m_spriteRatio = ratio;
+}
+
+QPixmap GameWidget::renderPieceSprite(ChessBoard::PieceType piece, PieceSprite variant, qreal ratio) const
+{
+    // 精灵覆盖一个格子，棋子居中；标记圈不超出格子范围
+    const int side = m_cellSize;
+    const QPointF center(side / 2.0, side / 2.0);
+    const qreal radius = m_pieceRadius;
+    
+    QPixmap sprite(QSize(side, side) * ratio);
+    sprite.setDevicePixelRatio(ratio);
+    sprite.fill(Qt::transparent);
+    
+    QPainter painter(&sprite);
+    painter.setRenderHint(QPainter::Antialiasing);
+    
+    // 获胜连线的棋子外加一圈光晕
+    if (variant == BlackWinning || variant == WhiteWinning) {
+        QRadialGradient glow(center, radius + 4);
+        glow.setColorAt(0.6, QColor(255, 215, 0, 200));
+        glow.setColorAt(1.0, QColor(255, 215, 0, 0));
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(glow);
+        painter.drawEllipse(center, radius + 4, radius + 4);
+    }
+    
+    // 投影
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 60));
+    painter.drawEllipse(center + QPointF(1.5, 1.5), radius, radius);
+    
+    // 高光偏左上的径向渐变，模拟立体感
+    QRadialGradient shade(center - QPointF(radius * 0.35, radius * 0.35), radius * 1.3);
+    if (piece == ChessBoard::Black) {
+        shade.setColorAt(0.0, m_blackPieceColor.lighter(400));
+        shade.setColorAt(0.35, m_blackPieceColor.lighter(200));
+        shade.setColorAt(1.0, m_blackPieceColor);
+        painter.setPen(QPen(Qt::gray, 1));
+    } else {
+        shade.setColorAt(0.0, m_whitePieceColor);
+        shade.setColorAt(0.7, m_whitePieceColor.darker(110));
+        shade.setColorAt(1.0, m_whitePieceColor.darker(140));
+        painter.setPen(QPen(Qt::black, 1));
+    }
+    painter.setBrush(shade);
+    painter.drawEllipse(center, radius, radius);
+    
+    if (variant == BlackLastMove || variant == WhiteLastMove) {
+        qreal markRadius = qMin(radius + 2, side / 2.0 - 1);
+        painter.setPen(QPen(m_lastMoveColor, 2));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawEllipse(center, markRadius, markRadius);
+    }
+    
+    return sprite;
+}
+
+void GameWidget::onBackgroundImageChanged(const QString& path)
+{
+    // 新的请求替换旧的future，旧的解码结果不会再送达；清除背景时靠路径为空过滤
+    m_backgroundPath = QFileInfo::exists(path) ? path : QString();
+    if (m_backgroundPath.isEmpty()) {
+        m_backgroundImage = QImage();
+        m_scaledBackground = QPixmap();
+        invalidateBoardCache();
+        return;
+    }
+    
+    m_backgroundWatcher->setFuture(QtConcurrent::run(&GameWidget::decodeBackground, path));
+}
+
+void GameWidget::onBackgroundDecoded()
+{
+    if (m_backgroundPath.isEmpty()) {
+        return;
+    }
+    m_backgroundImage = m_backgroundWatcher->result();
+    m_scaledBackground = QPixmap();
+    invalidateBoardCache();
+}
+
+QImage GameWidget::decodeBackground(const QString& path)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    
+    // JPEG等格式可以在解码时直接缩小，省去解码整张大图的时间和内存
+    QSize imageSize = reader.size();
+    if (imageSize.isValid() &&
+        (imageSize.width() > MAX_BACKGROUND_DIMENSION || imageSize.height() > MAX_BACKGROUND_DIMENSION)) {
+        reader.setScaledSize(imageSize.scaled(MAX_BACKGROUND_DIMENSION, MAX_BACKGROUND_DIMENSION,
+                                              Qt::KeepAspectRatio));
+    }
+    
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "无法加载背景图片:" << path << reader.errorString();
+    }
+    return image;
+}
+
+void GameWidget::rebuildScaledBackground()
+{
+    const float opacity = ConfigManager::instance()->backgroundOpacity();
+    const qreal ratio = devicePixelRatioF();
+    const QSize targetSize = size() * ratio;
+    
+    // 缩放并居中裁剪到窗口大小，透明度预先乘进位图，绘制时只是一次拷贝
+    QImage scaled = m_backgroundImage.scaled(targetSize, Qt::KeepAspectRatioByExpanding,
+                                             Qt::SmoothTransformation);
+    
+    QPixmap pixmap(targetSize);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    painter.setOpacity(opacity);
+    painter.drawImage((targetSize.width() - scaled.width()) / 2,
+                      (targetSize.height() - scaled.height()) / 2, scaled);
+    painter.end();
+    pixmap.setDevicePixelRatio(ratio);
+    
+    m_scaledBackground = pixmap;
+    m_scaledBackgroundOpacity = opacity;
 }
 
 void GameWidget::drawBackground(QPainter& painter)
 {
-    // 检查是否需要更新背景图片
-    ConfigManager* configManager = ConfigManager::instance();
-    QString backgroundPath = configManager->backgroundImage();
-    
-    if (!backgroundPath.isEmpty() && backgroundPath != m_currentBackgroundPath) {
-        if (QFileInfo::exists(backgroundPath)) {
-            m_backgroundPixmap.load(backgroundPath);
-            m_currentBackgroundPath = backgroundPath;
-        } else {
-            m_backgroundPixmap = QPixmap();
-            m_currentBackgroundPath.clear();
-        }
+    if (m_backgroundImage.isNull()) {
+        return;
     }
     
-    // 绘制背景图片
-    if (!m_backgroundPixmap.isNull()) {
-        float opacity = configManager->backgroundOpacity();
-        painter.setOpacity(opacity);
-        
-        // 缩放图片以适应窗口
-        QPixmap scaledPixmap = m_backgroundPixmap.scaled(
-            size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        
-        // 居中绘制
-        int x = (width() - scaledPixmap.width()) / 2;
-        int y = (height() - scaledPixmap.height()) / 2;
-        painter.drawPixmap(x, y, scaledPixmap);
-        
-        painter.setOpacity(1.0); // 恢复不透明度
+    // 只在尺寸或透明度变化时重新缩放
+    if (m_scaledBackground.isNull() ||
+        m_scaledBackground.size() != size() * devicePixelRatioF() ||
+        !qFuzzyCompare(m_scaledBackgroundOpacity, ConfigManager::instance()->backgroundOpacity())) {
+        rebuildScaledBackground();
     }
+    
+    painter.drawPixmap(0, 0, m_scaledBackground);
 }
 
 void GameWidget::drawBoard(QPainter& painter)
@@ -246,7 +588,7 @@ void GameWidget::drawCoordinates(QPainter& painter)
     }
 }
 
-void GameWidget::drawPieces(QPainter& painter)
+void GameWidget::drawPieces(QPainter& painter, const QRect& dirtyRect)
 {
     if (!m_gameEngine) {
         return;
@@ -257,75 +599,105 @@ void GameWidget::drawPieces(QPainter& painter)
         return;
     }
     
-    int pieceRadius = qMax(3, m_cellSize / 3);
+    QPoint lastMove(-1, -1);
+    if (m_showLastMove && board->hasHistory()) {
+        lastMove = board->lastMove();
+    }
+    m_markedLastMove = lastMove;
+    
+    // 只遍历与重绘区域相交的行列，每个棋子是一次位图拷贝
+    QPoint topLeft = pixelToBoardClamped(dirtyRect.topLeft());
+    QPoint bottomRight = pixelToBoardClamped(dirtyRect.bottomRight());
+    const int half = m_cellSize / 2;
     
-    for (int row = 0; row < ChessBoard::BOARD_SIZE; ++row) {
-        for (int col = 0; col < ChessBoard::BOARD_SIZE; ++col) {
+    for (int row = topLeft.y(); row <= bottomRight.y(); ++row) {
+        for (int col = topLeft.x(); col <= bottomRight.x(); ++col) {
             ChessBoard::PieceType piece = board->pieceAt(row, col);
-            if (piece != ChessBoard::Empty) {
-                QPoint pixelPos = boardToPixel(QPoint(col, row));
-                
-                // 设置棋子颜色
-                if (piece == ChessBoard::Black) {
-                    painter.setBrush(m_blackPieceColor);
-                    painter.setPen(QPen(Qt::gray, 1));
-                } else {
-                    painter.setBrush(m_whitePieceColor);
-                    painter.setPen(QPen(Qt::black, 1));
-                }
-                
-                painter.drawEllipse(pixelPos.x() - pieceRadius, pixelPos.y() - pieceRadius,
-                                   pieceRadius * 2, pieceRadius * 2);
+            if (piece == ChessBoard::Empty) {
+                continue;
             }
+            
+            QPoint position(col, row);
+            int sprite = (piece == ChessBoard::Black) ? BlackStone : WhiteStone;
+            if (m_winningLine.contains(position)) {
+                sprite += BlackWinning;
+            } else if (position == lastMove) {
+                sprite += BlackLastMove;
+            }
+            
+            QPoint pixelPos = boardToPixel(position);
+            painter.drawPixmap(pixelPos.x() - half, pixelPos.y() - half, m_pieceSprites[sprite]);
         }
     }
 }
 
-void GameWidget::drawLastMove(QPainter& painter)
+void GameWidget::drawHeatmap(QPainter& painter, const QRect& dirtyRect)
 {
-    if (!m_gameEngine) {
+    if (m_heatmapMode == HeatmapOff || !m_gameEngine || !m_gameEngine->chessBoard()) {
         return;
     }
     
     ChessBoard* board = m_gameEngine->chessBoard();
-    if (!board || !board->hasHistory()) {
-        return;
-    }
-    
-    QPoint lastMove = board->lastMove();
-    QPoint pixelPos = boardToPixel(lastMove);
-    
-    painter.setPen(QPen(m_lastMoveColor, 2));
-    painter.setBrush(Qt::NoBrush);
+    QPoint topLeft = pixelToBoardClamped(dirtyRect.topLeft());
+    QPoint bottomRight = pixelToBoardClamped(dirtyRect.bottomRight());
+    const int half = m_cellSize * 9 / 20;
     
-    int radius = qMax(5, m_cellSize / 3 + 2);
-    painter.drawEllipse(pixelPos.x() - radius, pixelPos.y() - radius,
-                       radius * 2, radius * 2);
+    painter.setPen(Qt::NoPen);
+    for (int row = topLeft.y(); row <= bottomRight.y(); ++row) {
+        for (int col = topLeft.x(); col <= bottomRight.x(); ++col) {
+            const float level = m_heatmapLevels[row * ChessBoard::BOARD_SIZE + col];
+            if (level < 0.0f || board->pieceAt(row, col) != ChessBoard::Empty) {
+                continue;
+            }
+            QPoint pixelPos = boardToPixel(QPoint(col, row));
+            painter.setBrush(heatmapColor(level));
+            painter.drawRoundedRect(pixelPos.x() - half, pixelPos.y() - half, half * 2, half * 2, 3, 3);
+        }
+    }
 }
 
-void GameWidget::drawHoverEffect(QPainter& painter)
+QColor GameWidget::heatmapColor(float level) const
+{
+    // 由蓝（低）经绿、黄到红（高），强度越高越不透明
+    QColor color = QColor::fromHsvF((1.0f - level) * 240.0f / 360.0f, 0.85, 1.0);
+    color.setAlphaF(0.25 + 0.35 * level);
+    return color;
+}
+
+QPoint GameWidget::visibleHoverPosition() const
 {
+    const QPoint hidden(-1, -1);
     if (!m_gameEngine || m_hoverPosition.x() < 0 || m_hoverPosition.y() < 0) {
-        return;
+        return hidden;
     }
     
     // 只在空位置显示悬停效果
     ChessBoard* board = m_gameEngine->chessBoard();
     if (!board || !board->isEmpty(m_hoverPosition)) {
-        return;
+        return hidden;
     }
     
     // 只在游戏进行中且轮到人类玩家时显示
     if (m_gameEngine->gameState() != GameEngine::Playing) {
-        return;
+        return hidden;
     }
     
     Player* currentPlayer = m_gameEngine->currentPlayerObject();
     if (!currentPlayer || currentPlayer->type() != Player::Human) {
+        return hidden;
+    }
+    
+    return m_hoverPosition;
+}
+
+void GameWidget::drawHoverEffect(QPainter& painter)
+{
+    QPoint hoverPosition = visibleHoverPosition();
+    if (hoverPosition.x() < 0) {
         return;
     }
     
-    QPoint pixelPos = boardToPixel(m_hoverPosition);
+    QPoint pixelPos = boardToPixel(hoverPosition);
     int radius = qMax(3, m_cellSize / 4);
     
     painter.setBrush(m_hoverColor);
@@ -334,6 +706,45 @@ void GameWidget::drawHoverEffect(QPainter& painter)
                        radius * 2, radius * 2);
 }
 
+void GameWidget::drawHints(QPainter& painter)
+{
+    if (m_hints.isEmpty() || !m_gameEngine) {
+        return;
+    }
+    
+    ChessBoard* board = m_gameEngine->chessBoard();
+    if (!board) {
+        return;
+    }
+    
+    int radius = qMax(5, m_cellSize / 3);
+    QFont font = painter.font();
+    font.setPointSize(qMax(7, m_cellSize / 3));
+    font.setBold(true);
+    painter.setFont(font);
+    
+    // 倒序绘制，使排名第一的提示压在最上层
+    for (int rank = m_hints.size() - 1; rank >= 0; --rank) {
+        const QPoint& move = m_hints[rank].move;
+        if (!board->isEmpty(move)) {
+            continue;
+        }
+        
+        QPoint pixelPos = boardToPixel(move);
+        QRect markerRect(pixelPos.x() - radius, pixelPos.y() - radius, radius * 2, radius * 2);
+        
+        // 首选着法不透明度更高并加粗描边
+        QColor fill = m_hintColor;
+        fill.setAlpha(rank == 0 ? 170 : 90);
+        painter.setBrush(fill);
+        painter.setPen(QPen(m_hintColor.darker(), rank == 0 ? 2 : 1));
+        painter.drawEllipse(markerRect);
+        
+        painter.setPen(Qt::white);
+        painter.drawText(markerRect, Qt::AlignCenter, QString::number(rank + 1));
+    }
+}
+
 QPoint GameWidget::pixelToBoard(const QPoint& pixel) const
 {
     if (!m_boardRect.contains(pixel)) {
@@ -351,6 +762,15 @@ QPoint GameWidget::pixelToBoard(const QPoint& pixel) const
     return QPoint(-1, -1);
 }
 
+QPoint GameWidget::pixelToBoardClamped(const QPoint& pixel) const
+{
+    // 向外取整，格子边缘半格内的像素也算作该格
+    int col = qRound((pixel.x() - m_boardRect.left()) / (double)m_cellSize);
+    int row = qRound((pixel.y() - m_boardRect.top()) / (double)m_cellSize);
+    return QPoint(qBound(0, col, ChessBoard::BOARD_SIZE - 1),
+                  qBound(0, row, ChessBoard::BOARD_SIZE - 1));
+}
+
 QPoint GameWidget::boardToPixel(const QPoint& board) const
 {
     int x = m_boardRect.left() + board.x() * m_cellSize;
@@ -373,4 +793,26 @@ QRect GameWidget::calculateBoardRect() const
     int y = (height() - boardSize) / 2;
     
     return QRect(x, y, boardSize, boardSize);
-} 
\ No newline at end of file
+}
+
+QRect GameWidget::cellRect(const QPoint& board) const
+{
+    // 以交叉点为中心的一个格子，留出描边宽度
+    QPoint center = boardToPixel(board);
+    int half = m_cellSize / 2 + 2;
+    return QRect(center.x() - half, center.y() - half, half * 2 + 1, half * 2 + 1);
+}
+
+void GameWidget::updateCell(const QPoint& board)
+{
+    if (board.x() >= 0 && board.y() >= 0) {
+        requestRepaint(cellRect(board));
+    }
+}
+
+void GameWidget::updateHintCells()
+{
+    for (const MinimaxSearch::RootMove& hint : m_hints) {
+        updateCell(hint.move);
+    }
+}
@@ -5,13 +5,28 @@
 #include <QPoint>
 #include <QRect>
 #include <QColor>
+#include <QVector>
+#include <QImage>
+#include <QPixmap>
+#include <QFutureWatcher>
 #include "core/GameEngine.h"
+#include "ai/MinimaxSearch.h"
+#include "ai/SearchHeatmap.h"
+
+class QTimer;
+
+class GLBoardView;
 
 class GameWidget : public QWidget
 {
     Q_OBJECT
+    
+    // OpenGL渲染器直接读取本控件的棋盘几何、样式和叠加层状态
+    friend class GLBoardView;
 
 public:
+    enum HeatmapMode { HeatmapOff, HeatmapScores, HeatmapVisits };
+    
     explicit GameWidget(QWidget *parent = nullptr);
     
     void setGameEngine(GameEngine* engine);
@@ -23,6 +38,22 @@ public:
     
     void setShowLastMove(bool show);
     bool showLastMove() const { return m_showLastMove; }
+    
+    // 落子提示，按推荐顺序排列；局面变化时自动清除
+    void setHints(const QVector<MinimaxSearch::RootMove>& hints);
+    void clearHints();
+    bool hasHints() const { return !m_hints.isEmpty(); }
+    
+    // 背景、网格和坐标缓存在一张位图里，外观设置改变后调用以重建
+    void invalidateBoardCache();
+    
+    // 显示搜索热力图：按固定帧率从source读取快照，source由调用方保证存活
+    void setHeatmap(const SearchHeatmap* source, HeatmapMode mode);
+    HeatmapMode heatmapMode() const { return m_heatmapMode; }
+    
+    // "raster"或"opengl"；OpenGL不可用时自动保持光栅绘制
+    void setRenderer(const QString& renderer);
+    bool isOpenGLActive() const { return m_glView != nullptr; }
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -35,21 +66,47 @@ private slots:
     void onMoveMade(const QPoint& position, ChessBoard::PieceType piece);
     void onMoveUndone(const QPoint& position);
     void onGameStateChanged(GameEngine::GameState state);
+    void onBackgroundImageChanged(const QString& path);
+    void onBackgroundDecoded();
+    void onOpenGLUnavailable();
+    void onHeatmapTick();
 
 signals:
     void positionClicked(const QPoint& position);
 
 private:
+    // 预渲染的棋子精灵，按格子大小和设备像素比生成
+    enum PieceSprite {
+        BlackStone, WhiteStone,
+        BlackLastMove, WhiteLastMove,
+        BlackWinning, WhiteWinning,
+        SpriteCount
+    };
+    
+    void requestRepaint(const QRect& rect = QRect());
+    void rebuildBoardCache();
+    void rebuildPieceSprites();
+    QPixmap renderPieceSprite(ChessBoard::PieceType piece, PieceSprite variant, qreal ratio) const;
+    void updateBoardGeometry();
     void drawBackground(QPainter& painter);
+    void rebuildScaledBackground();
+    static QImage decodeBackground(const QString& path);
     void drawBoard(QPainter& painter);
     void drawCoordinates(QPainter& painter);
-    void drawPieces(QPainter& painter);
-    void drawLastMove(QPainter& painter);
+    void drawPieces(QPainter& painter, const QRect& dirtyRect);
     void drawHoverEffect(QPainter& painter);
+    void drawHints(QPainter& painter);
+    void drawHeatmap(QPainter& painter, const QRect& dirtyRect);
+    QColor heatmapColor(float level) const;
+    QPoint visibleHoverPosition() const;
     
     QPoint pixelToBoard(const QPoint& pixel) const;
+    QPoint pixelToBoardClamped(const QPoint& pixel) const;
     QPoint boardToPixel(const QPoint& board) const;
     QRect calculateBoardRect() const;
+    QRect cellRect(const QPoint& board) const;
+    void updateCell(const QPoint& board);
+    void updateHintCells();
     
     GameEngine* m_gameEngine;
     
@@ -59,6 +116,9 @@ private:
     QPoint m_hoverPosition;
     bool m_showCoordinates;
     bool m_showLastMove;
+    QPoint m_markedLastMove;    // 当前画着最后一手标记的位置
+    GameRule::WinLine m_winningLine;
+    QVector<MinimaxSearch::RootMove> m_hints;
     
     // 样式
     QColor m_boardColor;
@@ -67,14 +127,43 @@ private:
     QColor m_whitePieceColor;
     QColor m_lastMoveColor;
     QColor m_hoverColor;
+    QColor m_hintColor;
     
     static const int MIN_CELL_SIZE = 20;
     static const int MAX_CELL_SIZE = 50;
     static const int BOARD_MARGIN = 30;
     
-    // 背景图片
-    QPixmap m_backgroundPixmap;
-    QString m_currentBackgroundPath;
+    // 静态棋盘缓存：仅在尺寸或外观变化时重建
+    QPixmap m_boardCache;
+    bool m_boardCacheValid;
+    
+    QPixmap m_pieceSprites[SpriteCount];
+    int m_pieceRadius;
+    int m_spriteCellSize;
+    qreal m_spriteRatio;
+    
+    // 背景图片：在线程池中解码，按窗口尺寸和透明度缓存缩放结果
+    QString m_backgroundPath;
+    QImage m_backgroundImage;
+    QPixmap m_scaledBackground;
+    float m_scaledBackgroundOpacity;
+    QFutureWatcher<QImage>* m_backgroundWatcher;
+    
+    // 热力图：m_heatmapLevels为归一化到0-1的强度，负数表示该格没有数据
+    const SearchHeatmap* m_heatmapSource;
+    HeatmapMode m_heatmapMode;
+    QTimer* m_heatmapTimer;
+    SearchHeatmap::Snapshot m_heatmapSnapshot;
+    quint64 m_heatmapSequence;
+    float m_heatmapLevels[SearchHeatmap::CELL_COUNT];
+    
+    static const int HEATMAP_FPS = 30;
+    
+    // OpenGL渲染器，为空时使用光栅绘制
+    GLBoardView* m_glView;
+    
+    // 解码时的最大边长，超大照片先在解码阶段缩小
+    static const int MAX_BACKGROUND_DIMENSION = 3840;
 };
 
 #endif // GAMEWIDGET_H 
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "LibraryDialog.h"
+#include "managers/GameLibrary.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QDialogButtonBox>
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+QString resultText(GameLibrary::Result result)
+{
+    switch (result) {
+        case GameLibrary::BlackWins:
+            return "黑胜";
+        case GameLibrary::WhiteWins:
+            return "白胜";
+        case GameLibrary::Draw:
+            return "和棋";
+        default:
+            return "未完";
+    }
+}
+}
+
+GameLibraryModel::GameLibraryModel(GameLibrary* library, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_library(library)
+    , m_subsetEnabled(false)
+    , m_sortColumn(DateColumn)
+    , m_sortOrder(Qt::DescendingOrder)
+    , m_resultFilter(-1)
+{
+    connect(m_library, &GameLibrary::gameAdded, this, &GameLibraryModel::onGameAdded);
+    rebuildRows();
+}
+
+int GameLibraryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int GameLibraryModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant GameLibraryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const int game = m_rows[index.row()];
+    if (role == Qt::TextAlignmentRole && index.column() == MovesColumn) {
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+        case DateColumn:
+            return QDateTime::fromMSecsSinceEpoch(m_library->timestamp(game)).toString("yyyy-MM-dd hh:mm");
+        case BlackColumn:
+            return m_library->blackName(game);
+        case WhiteColumn:
+            return m_library->whiteName(game);
+        case ResultColumn:
+            return resultText(m_library->result(game));
+        case MovesColumn:
+            return m_library->moveCount(game);
+        default:
+            return QVariant();
+    }
+}
+
+QVariant GameLibraryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    static const char* const titles[ColumnCount] = { "日期", "黑方", "白方", "结果", "步数" };
+    return (section >= 0 && section < ColumnCount) ? QString(titles[section]) : QVariant();
+}
+
+void GameLibraryModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    beginResetModel();
+    sortRows();
+    endResetModel();
+}
+
+void GameLibraryModel::setFilter(const QString& player, int result)
+{
+    m_playerFilter = player.trimmed();
+    m_resultFilter = result;
+
+    beginResetModel();
+    rebuildRows();
+    endResetModel();
+}
+
+void GameLibraryModel::setGameSubset(const QVector<int>& games)
+{
+    m_subset = games;
+    m_subsetEnabled = true;
+
+    beginResetModel();
+    rebuildRows();
+    endResetModel();
+}
+
+void GameLibraryModel::onGameAdded(int game)
+{
+    Q_UNUSED(game)
+    if (m_subsetEnabled) {
+        return;
+    }
+    beginResetModel();
+    rebuildRows();
+    endResetModel();
+}
+
+void GameLibraryModel::rebuildRows()
+{
+    m_rows.clear();
+    const int candidates = m_subsetEnabled ? m_subset.size() : m_library->gameCount();
+    m_rows.reserve(candidates);
+    for (int i = 0; i < candidates; ++i) {
+        const int game = m_subsetEnabled ? m_subset[i] : i;
+        if (game < 0 || game >= m_library->gameCount()) {
+            continue;
+        }
+        if (m_resultFilter >= 0 && m_library->result(game) != m_resultFilter) {
+            continue;
+        }
+        if (!m_playerFilter.isEmpty() &&
+            !m_library->blackName(game).contains(m_playerFilter, Qt::CaseInsensitive) &&
+            !m_library->whiteName(game).contains(m_playerFilter, Qt::CaseInsensitive)) {
+            continue;
+        }
+        m_rows.append(game);
+    }
+    sortRows();
+}
+
+void GameLibraryModel::sortRows()
+{
+    const bool ascending = (m_sortOrder == Qt::AscendingOrder);
+    auto sortBy = [this, ascending](auto key) {
+        std::stable_sort(m_rows.begin(), m_rows.end(), [&](int a, int b) {
+            return ascending ? key(a) < key(b) : key(b) < key(a);
+        });
+    };
+
+    switch (m_sortColumn) {
+        case BlackColumn:
+        case WhiteColumn: {
+            // 名字在排序前一次性解码，比较时不再反复转换UTF-8
+            QVector<QString> names(m_library->gameCount());
+            for (int game : m_rows) {
+                names[game] = (m_sortColumn == BlackColumn) ? m_library->blackName(game) : m_library->whiteName(game);
+            }
+            sortBy([&names](int game) -> const QString& { return names[game]; });
+            break;
+        }
+        case ResultColumn:
+            sortBy([this](int game) { return static_cast<int>(m_library->result(game)); });
+            break;
+        case MovesColumn:
+            sortBy([this](int game) { return m_library->moveCount(game); });
+            break;
+        default:
+            sortBy([this](int game) { return m_library->timestamp(game); });
+            break;
+    }
+}
+
+LibraryDialog::LibraryDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_library(GameLibrary::instance())
+    , m_model(nullptr)
+    , m_selectedGame(-1)
+{
+    if (!m_library->isOpen()) {
+        m_library->open();
+    }
+
+    setWindowTitle("棋谱库");
+    setModal(true);
+    resize(640, 480);
+    setupUI();
+    updateButtons();
+}
+
+void LibraryDialog::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // 筛选条件
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    m_playerFilterEdit = new QLineEdit(this);
+    m_playerFilterEdit->setPlaceholderText("按玩家名筛选");
+    m_playerFilterEdit->setClearButtonEnabled(true);
+    filterLayout->addWidget(m_playerFilterEdit, 1);
+
+    m_resultFilterCombo = new QComboBox(this);
+    m_resultFilterCombo->addItem("全部结果", -1);
+    m_resultFilterCombo->addItem("黑胜", GameLibrary::BlackWins);
+    m_resultFilterCombo->addItem("白胜", GameLibrary::WhiteWins);
+    m_resultFilterCombo->addItem("和棋", GameLibrary::Draw);
+    m_resultFilterCombo->addItem("未完", GameLibrary::Unfinished);
+    filterLayout->addWidget(m_resultFilterCombo);
+    mainLayout->addLayout(filterLayout);
+
+    connect(m_playerFilterEdit, &QLineEdit::textChanged, this, &LibraryDialog::onFilterChanged);
+    connect(m_resultFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &LibraryDialog::onFilterChanged);
+
+    // 对局列表：行高固定，视图不必为了滚动条逐行测量
+    m_model = new GameLibraryModel(m_library, this);
+    m_tableView = new QTableView(this);
+    m_tableView->setModel(m_model);
+    m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tableView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_tableView->setSortingEnabled(true);
+    m_tableView->sortByColumn(GameLibraryModel::DateColumn, Qt::DescendingOrder);
+    m_tableView->verticalHeader()->hide();
+    m_tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_tableView->horizontalHeader()->setStretchLastSection(true);
+    mainLayout->addWidget(m_tableView, 1);
+
+    connect(m_tableView, &QTableView::doubleClicked, this, &LibraryDialog::onOpenClicked);
+    connect(m_tableView->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &LibraryDialog::updateButtons);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &LibraryDialog::updateButtons);
+
+    // 按钮
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    m_countLabel = new QLabel(this);
+    buttonLayout->addWidget(m_countLabel, 1);
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(this);
+    m_openButton = buttonBox->addButton("打开", QDialogButtonBox::AcceptRole);
+    buttonBox->addButton("关闭", QDialogButtonBox::RejectRole);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &LibraryDialog::onOpenClicked);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    buttonLayout->addWidget(buttonBox);
+    mainLayout->addLayout(buttonLayout);
+}
+
+void LibraryDialog::setGameSubset(const QString& title, const QVector<int>& games)
+{
+    setWindowTitle(QString("棋谱库 - %1").arg(title));
+    m_model->setGameSubset(games);
+}
+
+void LibraryDialog::onFilterChanged()
+{
+    m_model->setFilter(m_playerFilterEdit->text(), m_resultFilterCombo->currentData().toInt());
+}
+
+void LibraryDialog::onOpenClicked()
+{
+    const QModelIndexList rows = m_tableView->selectionModel()->selectedRows();
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    m_selectedGame = m_model->gameAt(rows.first().row());
+    accept();
+}
+
+void LibraryDialog::updateButtons()
+{
+    m_openButton->setEnabled(m_tableView->selectionModel()->hasSelection());
+    m_countLabel->setText(QString("共 %1 局，显示 %2 局")
+                          .arg(m_library->gameCount())
+                          .arg(m_model->rowCount()));
+}
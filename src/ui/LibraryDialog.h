@@ -0,0 +1,85 @@
+#ifndef LIBRARYDIALOG_H
+#define LIBRARYDIALOG_H
+
+#include <QDialog>
+#include <QAbstractTableModel>
+#include <QTableView>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QVector>
+
+class GameLibrary;
+
+// 棋谱库的表格模型
+// 只保存显示顺序到对局编号的映射，单元格内容在视图请求时才从映射的索引项读取，
+// 十万局以上也只绘制可见的几十行。排序和筛选直接比较索引项中的字段。
+class GameLibraryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { DateColumn = 0, BlackColumn, WhiteColumn, ResultColumn, MovesColumn, ColumnCount };
+
+    explicit GameLibraryModel(GameLibrary* library, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // player为空、result为-1表示不限
+    void setFilter(const QString& player, int result);
+    // 只列出games中的对局，例如局面查询的结果；之后追加的对局不再显示
+    void setGameSubset(const QVector<int>& games);
+    int gameAt(int row) const { return m_rows[row]; }
+
+private slots:
+    void onGameAdded(int game);
+
+private:
+    void rebuildRows();
+    void sortRows();
+
+    GameLibrary* m_library;
+    QVector<int> m_rows;
+    QVector<int> m_subset;
+    bool m_subsetEnabled;
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+    QString m_playerFilter;
+    int m_resultFilter;
+};
+
+class LibraryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LibraryDialog(QWidget *parent = nullptr);
+
+    // 用户选择打开的对局编号，没有选择时为-1
+    int selectedGame() const { return m_selectedGame; }
+    void setGameSubset(const QString& title, const QVector<int>& games);
+
+private slots:
+    void onFilterChanged();
+    void onOpenClicked();
+    void updateButtons();
+
+private:
+    void setupUI();
+
+    GameLibrary* m_library;
+    GameLibraryModel* m_model;
+    QTableView* m_tableView;
+    QLineEdit* m_playerFilterEdit;
+    QComboBox* m_resultFilterCombo;
+    QLabel* m_countLabel;
+    QPushButton* m_openButton;
+    int m_selectedGame;
+};
+
+#endif // LIBRARYDIALOG_H
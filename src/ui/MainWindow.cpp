@@ -1,8 +1,15 @@
 #include "MainWindow.h"
 #include "ui/SettingsDialog.h"
+#include "ui/LibraryDialog.h"
+#include "managers/GameLibrary.h"
 #include <QApplication>
 #include <QCloseEvent>
 #include <QFileInfo>
+#include <QKeySequence>
+#include <QToolButton>
+#include <QMenu>
+#include <QActionGroup>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -10,12 +17,20 @@ MainWindow::MainWindow(QWidget *parent)
     , m_infoPanel(nullptr)
     , m_uiUpdateTimer(new QTimer(this))
     , m_gameEngine(new GameEngine(this))
+    , m_hintProvider(new HintProvider(this))
+    , m_analysisEngine(new AnalysisEngine(this))
+    , m_journal(new GameJournal(this))
     , m_configManager(ConfigManager::instance())
     , m_audioManager(AudioManager::instance())
 {
     setupUI();
     connectSignals();
     
+    // 恢复上次异常退出或直接关闭时没有下完的对局
+    if (m_journal->restore()) {
+        statusBar()->showMessage("已恢复上次未完成的对局", 5000);
+    }
+    
     // 启动UI更新计时器
     m_uiUpdateTimer->start(1000); // 每秒更新一次
     
@@ -79,6 +94,23 @@ void MainWindow::setupMenuBar()
     
     gameMenu->addSeparator();
     
+    QAction* saveGameAction = gameMenu->addAction("保存对局(&V)");
+    saveGameAction->setShortcut(QKeySequence::Save);
+    connect(saveGameAction, &QAction::triggered, this, &MainWindow::onSaveGame);
+    
+    QAction* libraryAction = gameMenu->addAction("棋谱库(&L)...");
+    libraryAction->setShortcut(QKeySequence::Open);
+    connect(libraryAction, &QAction::triggered, this, &MainWindow::onOpenLibrary);
+    
+    QAction* findPositionAction = gameMenu->addAction("查找相同局面(&F)...");
+    findPositionAction->setShortcut(QKeySequence::Find);
+    connect(findPositionAction, &QAction::triggered, this, &MainWindow::onFindPosition);
+    
+    QAction* findPatternAction = gameMenu->addAction("查找最后一手的棋形(&P)...");
+    connect(findPatternAction, &QAction::triggered, this, &MainWindow::onFindPattern);
+    
+    gameMenu->addSeparator();
+    
     QAction* settingsAction = gameMenu->addAction("设置(&T)");
     connect(settingsAction, &QAction::triggered, this, &MainWindow::onSettings);
     
@@ -115,10 +147,45 @@ void MainWindow::setupToolBar()
     connect(newGameAction, &QAction::triggered, this, &MainWindow::onNewGame);
     
     QAction* undoAction = toolBar->addAction("悔棋");
+    undoAction->setShortcut(QKeySequence::Undo);
     connect(undoAction, &QAction::triggered, this, &MainWindow::onUndo);
     
+    QAction* redoAction = toolBar->addAction("重做");
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::onRedo);
+    
     QAction* pauseAction = toolBar->addAction("暂停");
     connect(pauseAction, &QAction::triggered, this, &MainWindow::onPauseGame);
+    
+    QAction* hintAction = toolBar->addAction("提示");
+    hintAction->setShortcut(QKeySequence(Qt::Key_H));
+    connect(hintAction, &QAction::triggered, this, &MainWindow::onHint);
+    
+    m_analysisAction = toolBar->addAction("分析");
+    m_analysisAction->setCheckable(true);
+    connect(m_analysisAction, &QAction::toggled, this, &MainWindow::onAnalysisToggled);
+    
+    // 热力图数据来自后台分析，选择显示方式后自动打开分析
+    QToolButton* heatmapButton = new QToolButton(this);
+    heatmapButton->setText("热力图");
+    heatmapButton->setPopupMode(QToolButton::InstantPopup);
+    QMenu* heatmapMenu = new QMenu(heatmapButton);
+    QActionGroup* heatmapGroup = new QActionGroup(heatmapMenu);
+    const QPair<QString, GameWidget::HeatmapMode> heatmapModes[] = {
+        { "关闭", GameWidget::HeatmapOff },
+        { "着法评分", GameWidget::HeatmapScores },
+        { "搜索节点数", GameWidget::HeatmapVisits }
+    };
+    for (const auto& mode : heatmapModes) {
+        QAction* action = heatmapMenu->addAction(mode.first);
+        action->setCheckable(true);
+        action->setChecked(mode.second == GameWidget::HeatmapOff);
+        action->setData(static_cast<int>(mode.second));
+        heatmapGroup->addAction(action);
+    }
+    connect(heatmapGroup, &QActionGroup::triggered, this, &MainWindow::onHeatmapModeSelected);
+    heatmapButton->setMenu(heatmapMenu);
+    toolBar->addWidget(heatmapButton);
 }
 
 void MainWindow::setupStatusBar()
@@ -165,6 +232,20 @@ void MainWindow::setupCentralWidget()
     m_undoCountLabel = new QLabel("悔棋次数: 0", this);
     infoPanelLayout->addWidget(m_undoCountLabel);
     
+    // 拖动即可在当前分支上前后翻看，每次只重放相差的几手
+    m_plyLabel = new QLabel("棋谱: 0 / 0", this);
+    infoPanelLayout->addWidget(m_plyLabel);
+    
+    m_plySlider = new QSlider(Qt::Horizontal, this);
+    m_plySlider->setRange(0, 0);
+    connect(m_plySlider, &QSlider::valueChanged, this, &MainWindow::onPlySliderMoved);
+    infoPanelLayout->addWidget(m_plySlider);
+    
+    m_analysisLabel = new QLabel(this);
+    m_analysisLabel->setWordWrap(true);
+    m_analysisLabel->hide();
+    infoPanelLayout->addWidget(m_analysisLabel);
+    
     infoPanelLayout->addSpacing(20);
     
     // 操作按钮
@@ -180,6 +261,10 @@ void MainWindow::setupCentralWidget()
     connect(m_undoButton, &QPushButton::clicked, this, &MainWindow::onUndo);
     infoPanelLayout->addWidget(m_undoButton);
     
+    m_redoButton = new QPushButton("重做", this);
+    connect(m_redoButton, &QPushButton::clicked, this, &MainWindow::onRedo);
+    infoPanelLayout->addWidget(m_redoButton);
+    
     m_pauseButton = new QPushButton("暂停", this);
     connect(m_pauseButton, &QPushButton::clicked, this, &MainWindow::onPauseGame);
     infoPanelLayout->addWidget(m_pauseButton);
@@ -188,6 +273,10 @@ void MainWindow::setupCentralWidget()
     connect(m_restartButton, &QPushButton::clicked, this, &MainWindow::onRestartGame);
     infoPanelLayout->addWidget(m_restartButton);
     
+    m_hintButton = new QPushButton("提示", this);
+    connect(m_hintButton, &QPushButton::clicked, this, &MainWindow::onHint);
+    infoPanelLayout->addWidget(m_hintButton);
+    
     infoPanelLayout->addStretch();
     
     // 添加到主布局
@@ -206,6 +295,8 @@ void MainWindow::connectSignals()
             this, &MainWindow::onPlayerChanged);
     connect(m_gameEngine, &GameEngine::moveMade,
             this, &MainWindow::onMoveMade);
+    connect(m_gameEngine, &GameEngine::moveUndone,
+            this, &MainWindow::updateUI);
     connect(m_gameEngine, &GameEngine::gameWon,
             this, &MainWindow::onGameWon);
     connect(m_gameEngine, &GameEngine::gameDraw,
@@ -213,6 +304,35 @@ void MainWindow::connectSignals()
     connect(m_gameEngine, &GameEngine::errorOccurred,
             this, &MainWindow::onErrorOccurred);
     
+    // 自动保存：每步追加到日志，关闭设置时删除日志
+    m_journal->setGameEngine(m_gameEngine);
+    m_journal->setEnabled(m_configManager->autoSave());
+    connect(m_configManager, &ConfigManager::autoSaveChanged,
+            m_journal, &GameJournal::setEnabled);
+    
+    // 局面索引监听棋谱库的追加，对局一保存就补进索引
+    PositionIndex::instance();
+    
+    // 后台分析结果经排队信号回到界面线程
+    m_analysisEngine->setGameEngine(m_gameEngine);
+    connect(m_analysisEngine, &AnalysisEngine::infoUpdated,
+            this, &MainWindow::onAnalysisInfo);
+    connect(m_analysisEngine, &AnalysisEngine::analysisStarted, this, [this]() {
+        m_analysisLabel->setText("分析中...");
+    });
+    
+    // 提示结果在界面线程中回送；局面一变化旧的请求就没有意义了
+    connect(m_hintProvider, &HintProvider::hintsReady,
+            this, &MainWindow::onHintsReady);
+    connect(m_hintProvider, &HintProvider::hintsUnavailable,
+            this, &MainWindow::onHintsUnavailable);
+    connect(m_gameEngine, &GameEngine::moveMade,
+            m_hintProvider, &HintProvider::cancel);
+    connect(m_gameEngine, &GameEngine::moveUndone,
+            m_hintProvider, &HintProvider::cancel);
+    connect(m_gameEngine, &GameEngine::gameStateChanged,
+            m_hintProvider, &HintProvider::cancel);
+    
     // 连接UI更新计时器
     connect(m_uiUpdateTimer, &QTimer::timeout,
             this, &MainWindow::updateUI);
@@ -276,6 +396,122 @@ void MainWindow::onUndo()
     }
 }
 
+void MainWindow::onSaveGame()
+{
+    if (m_gameEngine->moveCount() == 0) {
+        statusBar()->showMessage("棋盘上还没有棋子，无需保存", 3000);
+        m_audioManager->playEffect(AudioManager::Error);
+        return;
+    }
+    
+    if (GameLibrary::instance()->addGame(m_gameEngine) >= 0) {
+        statusBar()->showMessage("对局已保存到棋谱库", 3000);
+        m_audioManager->playEffect(AudioManager::ButtonClick);
+    } else {
+        QMessageBox::warning(this, "保存失败", "无法写入棋谱库文件：\n" + GameLibrary::defaultPath());
+    }
+}
+
+void MainWindow::onOpenLibrary()
+{
+    showLibrary(QString(), QVector<PositionIndex::Occurrence>());
+}
+
+void MainWindow::onFindPosition()
+{
+    const ChessBoard* board = m_gameEngine->chessBoard();
+    if (board->moveCount() == 0) {
+        statusBar()->showMessage("棋盘上还没有棋子", 3000);
+        return;
+    }
+    
+    // 对称的局面视为相同
+    showLibrary("到达当前局面的对局", PositionIndex::instance()->findPosition(board));
+}
+
+void MainWindow::onFindPattern()
+{
+    const ChessBoard* board = m_gameEngine->chessBoard();
+    if (board->moveCount() == 0) {
+        statusBar()->showMessage("棋盘上还没有棋子", 3000);
+        return;
+    }
+    
+    showLibrary("最后一手周围出现过相同棋形的对局",
+                PositionIndex::instance()->findPattern(board, board->history().last()));
+}
+
+void MainWindow::showLibrary(const QString& title, const QVector<PositionIndex::Occurrence>& occurrences)
+{
+    LibraryDialog dialog(this);
+    
+    // 同一局可能多次出现同一棋形，结果按手数升序，第一次出现的就是最早的一手
+    QHash<int, int> firstPly;
+    if (!title.isEmpty()) {
+        QVector<int> games;
+        for (const PositionIndex::Occurrence& occurrence : occurrences) {
+            if (!firstPly.contains(occurrence.game)) {
+                firstPly.insert(occurrence.game, occurrence.ply);
+                games.append(occurrence.game);
+            }
+        }
+        dialog.setGameSubset(title, games);
+    }
+    
+    if (dialog.exec() != QDialog::Accepted || dialog.selectedGame() < 0) {
+        return;
+    }
+    
+    // 以人人对战方式载入，停在最后一手，可以用棋谱进度条翻看或接着往下摆
+    const int game = dialog.selectedGame();
+    const QVector<MoveIndex> moves = GameLibrary::instance()->moves(game);
+    if (!m_gameEngine->loadGame(GameEngine::PvP, moves)) {
+        QMessageBox::warning(this, "打开失败", "这局棋谱的着法不合法，可能已经损坏。");
+        return;
+    }
+    
+    if (firstPly.contains(game) && m_gameEngine->jumpToPly(firstPly.value(game))) {
+        statusBar()->showMessage(QString("已打开棋谱，跳到第 %1 手（共 %2 手）")
+                                 .arg(firstPly.value(game)).arg(moves.size()), 3000);
+    } else {
+        statusBar()->showMessage(QString("已打开棋谱，共 %1 手").arg(moves.size()), 3000);
+    }
+    updateUI();
+}
+
+void MainWindow::onRedo()
+{
+    if (m_gameEngine->redoMove()) {
+        m_audioManager->playEffect(AudioManager::PiecePlaced);
+    } else {
+        m_audioManager->playEffect(AudioManager::Error);
+    }
+}
+
+void MainWindow::onPlySliderMoved(int ply)
+{
+    if (ply != m_gameEngine->moveCount()) {
+        m_gameEngine->jumpToPly(ply);
+    }
+}
+
+void MainWindow::onHint()
+{
+    if (m_gameEngine->gameState() != GameEngine::Playing) {
+        return;
+    }
+    
+    // AI思考时不提供提示
+    Player* currentPlayer = m_gameEngine->currentPlayerObject();
+    if (!currentPlayer || currentPlayer->type() != Player::Human) {
+        return;
+    }
+    
+    m_hintProvider->requestHints(m_gameEngine->chessBoard(), m_gameEngine->currentPlayer());
+    statusBar()->showMessage("正在计算提示...");
+    m_audioManager->playEffect(AudioManager::ButtonClick);
+}
+
 void MainWindow::onSettings()
 {
     SettingsDialog dialog(this);
@@ -285,20 +521,21 @@ void MainWindow::onSettings()
         m_audioManager->setMasterVolume(m_configManager->volume());
         m_audioManager->setMuted(!m_configManager->soundEffectsEnabled());
         
-        // 更新背景音乐
-        m_audioManager->stopBackgroundMusic();
+        // 更新背景音乐：换曲时交叉淡化，曲目未变时继续播放
         QString newMusicPath = m_configManager->backgroundMusic();
         if (!newMusicPath.isEmpty() && QFileInfo::exists(newMusicPath)) {
             m_audioManager->playBackgroundMusic();
             statusBar()->showMessage(QString("背景音乐已更新: %1").arg(QFileInfo(newMusicPath).baseName()), 3000);
         } else if (!newMusicPath.isEmpty()) {
+            m_audioManager->stopBackgroundMusic();
             statusBar()->showMessage("背景音乐文件不存在", 3000);
         } else {
+            m_audioManager->stopBackgroundMusic();
             statusBar()->showMessage("背景音乐已关闭", 3000);
         }
         
-        // 更新游戏界面（包括背景图片）
-        m_gameWidget->update();
+        // 更新游戏界面（包括背景图片和透明度）
+        m_gameWidget->invalidateBoardCache();
         
         // 如果窗口大小发生变化，调整窗口
         QSize newSize = m_configManager->windowSize();
@@ -367,6 +604,8 @@ void MainWindow::onMoveMade(const QPoint& position, ChessBoard::PieceType piece)
 
 void MainWindow::onGameWon(ChessBoard::PieceType winner)
 {
+    archiveFinishedGame();
+    
     QString winnerText = (winner == ChessBoard::Black) ? "黑方" : "白方";
     QMessageBox::information(this, "游戏结束", 
                            QString("恭喜！%1获胜！\n\n游戏用时: %2\n总步数: %3")
@@ -378,26 +617,109 @@ void MainWindow::onGameWon(ChessBoard::PieceType winner)
 
 void MainWindow::onGameDraw()
 {
-    QMessageBox::information(this, "游戏结束", "平局！棋盘已满，无人获胜。");
+    archiveFinishedGame();
+    
+    // 提前判和时棋盘还没下满，按实际原因提示
+    QString message = m_gameEngine->chessBoard()->isFull()
+        ? "平局！棋盘已满，无人获胜。"
+        : "平局！双方都已无法连成五子。";
+    QMessageBox::information(this, "游戏结束", message);
     m_audioManager->playEffect(AudioManager::GameDraw);
 }
 
+void MainWindow::archiveFinishedGame()
+{
+    // 开启自动保存时，下完的对局自动收进棋谱库，局面索引随之增量更新；
+    // 从棋谱库载入后退回重下、或悔棋后重新下出同一终局时，库里已有这一局，不再重复收录
+    if (!m_configManager->autoSave() || PositionIndex::instance()->findGame(m_gameEngine->chessBoard()) >= 0) {
+        return;
+    }
+    if (GameLibrary::instance()->addGame(m_gameEngine) < 0) {
+        statusBar()->showMessage("对局未能保存到棋谱库", 3000);
+    }
+}
+
 void MainWindow::onErrorOccurred(const QString& message)
 {
     statusBar()->showMessage(QString("错误: %1").arg(message), 3000);
     m_audioManager->playEffect(AudioManager::Error);
 }
 
+void MainWindow::onHintsReady(const QVector<MinimaxSearch::RootMove>& hints)
+{
+    m_gameWidget->setHints(hints);
+    
+    const QPoint& best = hints.first().move;
+    statusBar()->showMessage(QString("推荐落子: %1%2（评分 %3）")
+                             .arg(QChar('A' + best.x()))
+                             .arg(ChessBoard::BOARD_SIZE - best.y())
+                             .arg(hints.first().score), 5000);
+}
+
+void MainWindow::onHintsUnavailable()
+{
+    statusBar()->showMessage("暂时无法给出提示", 3000);
+}
+
+void MainWindow::onAnalysisToggled(bool enabled)
+{
+    m_analysisEngine->setEnabled(enabled);
+    m_analysisLabel->setVisible(enabled);
+    m_analysisLabel->setText(enabled ? "分析中..." : QString());
+}
+
+void MainWindow::onAnalysisInfo(const AnalysisEngine::Info& info)
+{
+    QStringList lines;
+    lines << QString("分析（%1方）深度 %2").arg(info.side == ChessBoard::Black ? "黑" : "白").arg(info.depth);
+    for (int i = 0; i < info.lines.size(); ++i) {
+        const MinimaxSearch::RootMove& line = info.lines[i];
+        lines << QString("%1. %2%3  %4")
+                     .arg(i + 1)
+                     .arg(QChar('A' + line.move.x()))
+                     .arg(ChessBoard::BOARD_SIZE - line.move.y())
+                     .arg(line.score);
+    }
+    lines << QString("%1 节点 / %2 ms").arg(info.nodes).arg(info.elapsedMs);
+    
+    // 整盘棋型由位棋盘一次扫描得出
+    const LineBoard& board = m_gameEngine->chessBoard()->lines();
+    const ChessBoard::PieceType sides[2] = { ChessBoard::Black, ChessBoard::White };
+    for (ChessBoard::PieceType side : sides) {
+        const LineBoard::PatternCounts counts = board.scan(side);
+        lines << QString("%1方 活四 %2  冲四点 %3  活三 %4")
+                     .arg(side == ChessBoard::Black ? "黑" : "白")
+                     .arg(counts.openFours)
+                     .arg(counts.fours)
+                     .arg(counts.openThrees);
+    }
+    m_analysisLabel->setText(lines.join('\n'));
+}
+
+void MainWindow::onHeatmapModeSelected(QAction* action)
+{
+    GameWidget::HeatmapMode mode = static_cast<GameWidget::HeatmapMode>(action->data().toInt());
+    if (mode != GameWidget::HeatmapOff && !m_analysisAction->isChecked()) {
+        m_analysisAction->setChecked(true);
+    }
+    m_gameWidget->setHeatmap(m_analysisEngine->heatmap(), mode);
+}
+
 void MainWindow::updateUI()
 {
     // 更新按钮状态
     bool gameActive = (m_gameEngine->gameState() == GameEngine::Playing || 
                       m_gameEngine->gameState() == GameEngine::Paused);
     
-    m_undoButton->setEnabled(gameActive && m_gameEngine->canUndo());
+    m_undoButton->setEnabled(m_gameEngine->canUndo());
+    m_redoButton->setEnabled(m_gameEngine->canRedo());
     m_pauseButton->setEnabled(gameActive);
     m_restartButton->setEnabled(gameActive);
     
+    Player* currentPlayer = m_gameEngine->currentPlayerObject();
+    m_hintButton->setEnabled(m_gameEngine->gameState() == GameEngine::Playing &&
+                             currentPlayer && currentPlayer->type() == Player::Human);
+    
     // 更新暂停按钮文本
     if (m_gameEngine->gameState() == GameEngine::Paused) {
         m_pauseButton->setText("继续");
@@ -405,6 +727,15 @@ void MainWindow::updateUI()
         m_pauseButton->setText("暂停");
     }
     
+    // 进度条跟随当前分支，程序设置数值时不触发跳转
+    const GameRecord& record = m_gameEngine->record();
+    const bool navigable = m_gameEngine->canUndo() || m_gameEngine->canRedo();
+    QSignalBlocker blocker(m_plySlider);
+    m_plySlider->setRange(0, record.lineLength());
+    m_plySlider->setValue(record.ply());
+    m_plySlider->setEnabled(navigable);
+    m_plyLabel->setText(QString("棋谱: %1 / %2").arg(record.ply()).arg(record.lineLength()));
+    
     updateStatusBar();
 }
 
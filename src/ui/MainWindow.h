@@ -7,6 +7,7 @@
 #include <QStatusBar>
 #include <QLabel>
 #include <QPushButton>
+#include <QSlider>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -14,8 +15,12 @@
 
 #include "GameWidget.h"
 #include "core/GameEngine.h"
+#include "ai/HintProvider.h"
+#include "ai/AnalysisEngine.h"
 #include "managers/ConfigManager.h"
 #include "managers/AudioManager.h"
+#include "managers/GameJournal.h"
+#include "managers/PositionIndex.h"
 
 class MainWindow : public QMainWindow
 {
@@ -36,6 +41,13 @@ private slots:
     void onPauseGame();
     void onRestartGame();
     void onUndo();
+    void onSaveGame();
+    void onOpenLibrary();
+    void onFindPosition();
+    void onFindPattern();
+    void onRedo();
+    void onPlySliderMoved(int ply);
+    void onHint();
     void onSettings();
     void onExit();
     void onAbout();
@@ -47,6 +59,11 @@ private slots:
     void onGameWon(ChessBoard::PieceType winner);
     void onGameDraw();
     void onErrorOccurred(const QString& message);
+    void onHintsReady(const QVector<MinimaxSearch::RootMove>& hints);
+    void onHintsUnavailable();
+    void onAnalysisToggled(bool enabled);
+    void onAnalysisInfo(const AnalysisEngine::Info& info);
+    void onHeatmapModeSelected(QAction* action);
     
     // UI更新
     void updateUI();
@@ -62,6 +79,9 @@ private:
     void setupStatusBar();
     void setupCentralWidget();
     void connectSignals();
+    void archiveFinishedGame();
+    // title非空时只列出occurrences中的对局，打开后跳到最早到达的那一手
+    void showLibrary(const QString& title, const QVector<PositionIndex::Occurrence>& occurrences);
     
     // UI组件
     GameWidget* m_gameWidget;
@@ -72,19 +92,28 @@ private:
     QLabel* m_gameTimeLabel;
     QLabel* m_moveCountLabel;
     QLabel* m_undoCountLabel;
+    QLabel* m_plyLabel;
     QLabel* m_gameStateLabel;
+    QLabel* m_analysisLabel;
     
     // 操作按钮
     QPushButton* m_newGameButton;
     QPushButton* m_undoButton;
+    QPushButton* m_redoButton;
     QPushButton* m_pauseButton;
     QPushButton* m_restartButton;
+    QPushButton* m_hintButton;
+    QAction* m_analysisAction;
+    QSlider* m_plySlider;
     
     // 计时器
     QTimer* m_uiUpdateTimer;
     
     // 核心组件
     GameEngine* m_gameEngine;
+    HintProvider* m_hintProvider;
+    AnalysisEngine* m_analysisEngine;
+    GameJournal* m_journal;
     ConfigManager* m_configManager;
     AudioManager* m_audioManager;
 };
@@ -126,6 +126,11 @@ void SettingsDialog::setupDisplayPage()
     m_languageCombo->addItem("English", "en_US");
     interfaceLayout->addRow("语言:", m_languageCombo);
     
+    m_rendererCombo = new QComboBox();
+    m_rendererCombo->addItem("软件绘制", "raster");
+    m_rendererCombo->addItem("OpenGL（不支持时自动回退）", "opengl");
+    interfaceLayout->addRow("渲染方式:", m_rendererCombo);
+    
     layout->addWidget(interfaceGroup);
     
     // 窗口设置
@@ -275,6 +280,7 @@ void SettingsDialog::loadSettings()
     // 加载显示设置
     QString language = m_configManager->language();
     m_languageCombo->setCurrentIndex(m_languageCombo->findData(language));
+    m_rendererCombo->setCurrentIndex(qMax(0, m_rendererCombo->findData(m_configManager->renderer())));
     
     QSize windowSize = m_configManager->windowSize();
     m_windowWidthSpin->setValue(windowSize.width());
@@ -321,6 +327,7 @@ void SettingsDialog::applySettings()
     // 应用显示设置
     QString language = m_languageCombo->currentData().toString();
     m_configManager->setLanguage(language);
+    m_configManager->setRenderer(m_rendererCombo->currentData().toString());
     
     QSize windowSize(m_windowWidthSpin->value(), m_windowHeightSpin->value());
     m_configManager->setWindowSize(windowSize);
@@ -52,6 +52,7 @@ private:
     
     // 显示设置
     QComboBox* m_languageCombo;
+    QComboBox* m_rendererCombo;
     QSpinBox* m_windowWidthSpin;
     QSpinBox* m_windowHeightSpin;
     QLineEdit* m_backgroundImageEdit;
@@ -0,0 +1,110 @@
+// LineBoard整盘棋型扫描的一致性检查
+// 随机棋盘上比较AVX2、SSE4和标量三种实现的计数（当前CPU不支持的实现跳过），
+// 并用逐格枚举窗口的朴素做法核对连五、活四和冲四点的数量。
+
+#include <cstdio>
+#include <random>
+
+#include "core/LineBoard.h"
+
+namespace {
+const int BOARD_SIZE = MoveIndex::BOARD_SIZE;
+const int DIRECTIONS[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+int cellAt(const int cells[BOARD_SIZE][BOARD_SIZE], int row, int col)
+{
+    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) {
+        return -1;
+    }
+    return cells[row][col];
+}
+
+// 朴素计数：五格窗口内五子为连五、四子一空为冲四点；六格窗口两端为空、中间四子为活四
+LineBoard::PatternCounts naiveCounts(const int cells[BOARD_SIZE][BOARD_SIZE], int piece)
+{
+    LineBoard::PatternCounts counts;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            for (const int* d : DIRECTIONS) {
+                int own = 0;
+                int empty = 0;
+                for (int i = 0; i < 5; ++i) {
+                    const int cell = cellAt(cells, row + d[0] * i, col + d[1] * i);
+                    own += (cell == piece);
+                    empty += (cell == 0);
+                }
+                if (own == 5) {
+                    counts.fives++;
+                }
+                if (own == 4 && empty == 1) {
+                    counts.fours++;
+                }
+
+                bool openFour = cellAt(cells, row, col) == 0 && cellAt(cells, row + d[0] * 5, col + d[1] * 5) == 0;
+                for (int i = 1; i <= 4 && openFour; ++i) {
+                    openFour = cellAt(cells, row + d[0] * i, col + d[1] * i) == piece;
+                }
+                if (openFour) {
+                    counts.openFours++;
+                }
+            }
+        }
+    }
+    return counts;
+}
+
+bool sameCounts(const LineBoard::PatternCounts& a, const LineBoard::PatternCounts& b)
+{
+    return a.fives == b.fives && a.openFours == b.openFours && a.fours == b.fours && a.openThrees == b.openThrees;
+}
+}
+
+int main()
+{
+    const LineBoard::ScanPath paths[] = { LineBoard::Avx2Path, LineBoard::Sse4Path };
+    const char* pathNames[] = { "avx2", "sse4" };
+    for (int p = 0; p < 2; ++p) {
+        std::printf("%s: %s\n", pathNames[p], LineBoard::isScanPathSupported(paths[p]) ? "tested" : "unsupported, skipped");
+    }
+    std::printf("auto: %s\n", LineBoard::simdPath());
+
+    std::mt19937 rng(20240611);
+    int failures = 0;
+    for (int round = 0; round < 20000 && failures < 10; ++round) {
+        // 密度从稀疏到接近满盘，覆盖长连和各种边界情况
+        const int density = static_cast<int>(rng() % 90) + 5;
+        int cells[BOARD_SIZE][BOARD_SIZE] = {};
+        LineBoard board;
+        for (int row = 0; row < BOARD_SIZE; ++row) {
+            for (int col = 0; col < BOARD_SIZE; ++col) {
+                if (static_cast<int>(rng() % 100) < density) {
+                    cells[row][col] = static_cast<int>(rng() % 2) + 1;
+                    board.place(MoveIndex::fromRowCol(row, col), cells[row][col]);
+                }
+            }
+        }
+
+        for (int piece = 1; piece <= 2; ++piece) {
+            const LineBoard::PatternCounts scalar = board.scan(piece, LineBoard::ScalarPath);
+            const LineBoard::PatternCounts naive = naiveCounts(cells, piece);
+            if (scalar.fives != naive.fives || scalar.openFours != naive.openFours || scalar.fours != naive.fours) {
+                std::printf("FAIL round %d piece %d: scalar %d/%d/%d naive %d/%d/%d (fives/openFours/fours)\n",
+                            round, piece, scalar.fives, scalar.openFours, scalar.fours,
+                            naive.fives, naive.openFours, naive.fours);
+                failures++;
+            }
+            if (!sameCounts(board.scan(piece), scalar)) {
+                std::printf("FAIL round %d piece %d: auto path differs from scalar\n", round, piece);
+                failures++;
+            }
+            for (int p = 0; p < 2; ++p) {
+                if (LineBoard::isScanPathSupported(paths[p]) && !sameCounts(board.scan(piece, paths[p]), scalar)) {
+                    std::printf("FAIL round %d piece %d: %s differs from scalar\n", round, piece, pathNames[p]);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// MinimaxSearch零分配检查
+// 在固定局面上以不同深度搜索，统计搜索期间的全部堆分配：
+// 除了operator new，Qt容器（QList/QVector/QSet/QHash）直接调用::malloc申请存储，
+// 因此在glibc上替换malloc/calloc/realloc计数（operator new也经由malloc）。
+// 预热建立每线程的SearchArena之后，任何深度的搜索都不应再有堆分配。
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <atomic>
+
+#include "ai/MinimaxSearch.h"
+
+namespace {
+std::atomic<long> g_allocations(0);
+std::atomic_bool g_counting(false);
+
+// CTest按SKIP_RETURN_CODE把该返回值记为跳过
+const int SKIP_RETURN_CODE = 77;
+
+inline void countAllocation()
+{
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+}
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* p, std::size_t size);
+
+// 可执行文件中的定义优先于libc，Qt和libstdc++里的调用同样经过这里
+void* malloc(std::size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, std::size_t size)
+{
+    countAllocation();
+    return __libc_realloc(p, size);
+}
+}
+#endif
+
+namespace {
+struct SearchRun {
+    quint64 nodes;
+    long allocations;
+};
+
+SearchRun runSearch(const ChessBoard* board, int depth)
+{
+    MinimaxSearch search(ChessBoard::White, depth);
+    g_allocations = 0;
+    g_counting = true;
+    search.findBestMove(board);
+    g_counting = false;
+    return SearchRun{ search.nodeCount(), g_allocations.load() };
+}
+
+// 确认计数确实生效：malloc和operator new各一次
+bool hooksActive()
+{
+    g_allocations = 0;
+    g_counting = true;
+    void* volatile raw = std::malloc(16);
+    int* volatile object = new int(0);
+    g_counting = false;
+    std::free(raw);
+    delete object;
+    return g_allocations.load() >= 2;
+}
+}
+
+int main()
+{
+#ifndef __GLIBC__
+    std::printf("SKIP: malloc interposition is only implemented for glibc\n");
+    return SKIP_RETURN_CODE;
+#endif
+
+    if (!hooksActive()) {
+        std::printf("FAIL: allocation counting hooks are not active\n");
+        return 1;
+    }
+
+    // 开局几手的固定局面，黑方已有三连需要应对
+    ChessBoard board;
+    board.placePiece(QPoint(7, 7), ChessBoard::Black);
+    board.placePiece(QPoint(8, 8), ChessBoard::White);
+    board.placePiece(QPoint(6, 7), ChessBoard::Black);
+    board.placePiece(QPoint(8, 7), ChessBoard::White);
+    board.placePiece(QPoint(5, 7), ChessBoard::Black);
+
+    // 第一次搜索为本线程建立SearchArena，之后的搜索复用它
+    runSearch(&board, 1);
+
+    const SearchRun shallow = runSearch(&board, 2);
+    const SearchRun deep = runSearch(&board, 4);
+    std::printf("depth 2: %llu nodes, %ld allocations\n",
+                static_cast<unsigned long long>(shallow.nodes), shallow.allocations);
+    std::printf("depth 4: %llu nodes, %ld allocations\n",
+                static_cast<unsigned long long>(deep.nodes), deep.allocations);
+
+    if (deep.nodes <= shallow.nodes) {
+        std::printf("FAIL: deeper search did not visit more nodes\n");
+        return 1;
+    }
+    if (shallow.allocations != 0 || deep.allocations != 0) {
+        std::printf("FAIL: the search allocated on the heap\n");
+        return 1;
+    }
+    return 0;
+}